@@ -1,14 +1,17 @@
 #version 150
 
 uniform sampler2D tex;
+uniform vec2 textureScale;
 
+in vec2 frag_tile;
 in vec3 frag_uv;
 
 out vec4 out_color;
 
 void main()
 {
-    vec4 color = texture(tex, frag_uv.xy);
+    vec2 uv = frag_uv.xy * textureScale;
+    vec4 color = textureGrad(tex, frag_tile + fract(frag_uv.xy) * textureScale, dFdx(uv), dFdy(uv));
     out_color = vec4(color.xyz * frag_uv.z, 1.0);
     //out_color = vec4(1.0, 0.0, 1.0, 1.0);
 }
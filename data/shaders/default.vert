@@ -2,14 +2,32 @@
 
 uniform mat4 mvp;
 uniform vec2 textureOffset;
+uniform vec2 textureScale;
+uniform isamplerBuffer chunkOffsets;
 
-in vec4 position;
-in vec2 in_uv;
+in uvec2 position;
 
+out vec2 frag_tile;
 out vec3 frag_uv;
 
+const float faceIlluminance[6] = float[6](1.0, 0.1, 0.5, 0.8, 0.7, 0.4);
+
 void main()
 {
-    gl_Position = mvp * vec4(position.xyz, 1.0);
-	frag_uv = vec3(in_uv + textureOffset, position.w);
+	uint geometry = position.x;
+	uint tile = position.y;
+
+	vec3 blockPosition = vec3(geometry & 31u, (geometry >> 5) & 255u, (geometry >> 13) & 31u);
+	uint face = (geometry >> 18) & 7u;
+	uint ao = (geometry >> 21) & 3u;
+	uint slot = (geometry >> 23) | ((tile >> 26) << 9);
+
+	if (slot != 0u) {
+		ivec2 chunk = texelFetch(chunkOffsets, int(slot)).xy;
+		blockPosition += vec3(chunk.x * 16, 0, chunk.y * 16);
+	}
+
+    gl_Position = mvp * vec4(blockPosition, 1.0);
+	frag_tile = vec2(tile & 255u, (tile >> 8) & 255u) * textureScale + textureOffset;
+	frag_uv = vec3((tile >> 16) & 31u, (tile >> 21) & 31u, faceIlluminance[face] + float(ao) * 0.1 - 0.3);
 }
@@ -0,0 +1,19 @@
+#version 150
+
+uniform vec3 color;
+uniform vec2 fogRange;
+
+in vec2 frag_shading;
+in float frag_distance;
+
+out vec4 out_color;
+
+const vec3 grassColor = vec3(0.35, 0.55, 0.25);
+const vec3 dirtColor = vec3(0.45, 0.33, 0.22);
+
+void main()
+{
+    vec3 surface = mix(grassColor, dirtColor, frag_shading.y) * frag_shading.x;
+    float fog = clamp((frag_distance - fogRange.x) / (fogRange.y - fogRange.x), 0.0, 1.0);
+    out_color = vec4(mix(surface, color, fog), 1.0);
+}
@@ -0,0 +1,17 @@
+#version 150
+
+uniform mat4 mvp;
+uniform vec3 cameraPosition;
+
+in vec3 position;
+in vec2 in_uv;
+
+out vec2 frag_shading;
+out float frag_distance;
+
+void main()
+{
+    gl_Position = mvp * vec4(position, 1.0);
+    frag_shading = in_uv;
+    frag_distance = length(position.xz - cameraPosition.xz);
+}
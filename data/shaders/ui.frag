@@ -1,17 +1,17 @@
 #version 150
 
 uniform sampler2D tex;
-uniform vec3 color;
 
 in vec2 frag_uv;
+in vec4 frag_color;
 
 out vec4 out_color;
 
 void main()
 {
-    vec4 textureColor = texture(tex, frag_uv);
+    vec4 textureColor = frag_uv.x >= 0.0 ? texture(tex, frag_uv) : vec4(1.0);
     if(textureColor.r == 1.0 && textureColor.b == 1.0 && textureColor.g == 0.0) {
 	    discard;
 	}
-    out_color = vec4(textureColor.xyz * color, 1);
+    out_color = vec4(textureColor.xyz * frag_color.xyz, frag_color.a);
 }
\ No newline at end of file
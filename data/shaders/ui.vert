@@ -1,16 +1,17 @@
 #version 150
 
 uniform mat4 mvp;
-uniform vec2 textureOffset;
-uniform vec2 textureScale;
 
 in vec3 position;
 in vec2 in_uv;
+in vec4 in_color;
 
 out vec2 frag_uv;
+out vec4 frag_color;
 
 void main()
 {
     gl_Position = mvp * vec4(position, 1.0);
-	frag_uv = in_uv * textureScale + textureOffset;
+	frag_uv = in_uv;
+	frag_color = in_color;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <gl3w.h>
 #include <GLFW/glfw3.h>
 #include <stdexcept>
+#include <algorithm>
 #include "View.h"
 #include "GameView.h"
 #include <chrono>
@@ -53,6 +54,7 @@ namespace yamc
 		glfwSetFramebufferSizeCallback(window, windowSizeCallback);
 		glfwSetScrollCallback(window, scrollCallback);
 		glfwSetMouseButtonCallback(window, mouseButtonCallback);
+		glfwSetKeyCallback(window, keyCallback);
 		glfwSwapInterval(0);
 		glfwGetWindowSize(window, &windowWidth, &windowHeight);
 
@@ -134,6 +136,16 @@ namespace yamc
 		settings.initialScreenHeight = 600;
 		settings.initialScreenWidth = 800;
 		settings.visibleChunkRadius = 4;
+		settings.fullDetailChunkRadius = 4;
+		settings.horizonChunkRadius = 40;
+		settings.prefetchChunkBudget = 96;
+		settings.useHugePagesForChunks = false;
+		settings.useGreedyMeshing = true;
+		settings.meshingWorkerCount = 2;
+		settings.generationWorkerCount = (std::max)(std::thread::hardware_concurrency() / 2, 1u);
+		settings.meshUploadBudgetBytes = 2 * 1024 * 1024;
+		settings.meshUploadBudgetMilliseconds = 2.0f;
+		settings.meshNeighborTimeoutMilliseconds = 500.0f;
 	}
 
 	void Application::loadInitialView()
@@ -141,6 +153,15 @@ namespace yamc
 		auto game = new SinglePlayerGame(542917, "test", getSettings()->visibleChunkRadius);
 		//auto serverAddress = loadDummyConfigString();
 		//auto game = new MultiPlayerGame(serverAddress, 8888, getSettings()->visibleChunkRadius);
+		game->getTerrain().getChunkPool().setHugePagesEnabled(getSettings()->useHugePagesForChunks);
+		game->setGreedyMeshingEnabled(getSettings()->useGreedyMeshing);
+		game->setMeshingWorkerCount(getSettings()->meshingWorkerCount);
+		game->setGenerationWorkerCount(getSettings()->generationWorkerCount);
+		game->setMeshUploadBudget(getSettings()->meshUploadBudgetBytes, getSettings()->meshUploadBudgetMilliseconds);
+		game->setFullDetailChunkRadius(getSettings()->fullDetailChunkRadius);
+		game->setMeshNeighborTimeout(getSettings()->meshNeighborTimeoutMilliseconds);
+		game->setHorizonChunkRadius(getSettings()->horizonChunkRadius);
+		game->setPrefetchChunkBudget(getSettings()->prefetchChunkBudget);
 		currentView = new GameView(this, game);
 		currentView->init();
 	}
@@ -179,4 +200,13 @@ namespace yamc
 			application->currentView->onMouseRelease(button, mods);
 		}
 	}
-}
+
+	void Application::keyCallback(GLFWwindow* window, int key, int, int action, int mods)
+	{
+		auto application = (Application*)glfwGetWindowUserPointer(window);
+
+		if (action == GLFW_PRESS) {
+			application->currentView->onKeyPress(key, mods);
+		}
+	}
+}
\ No newline at end of file
@@ -12,6 +12,16 @@ namespace yamc
 		int initialScreenWidth;
 		int initialScreenHeight;
 		int visibleChunkRadius;
+		int fullDetailChunkRadius;
+		int horizonChunkRadius;
+		uint32_t prefetchChunkBudget;
+		bool useHugePagesForChunks;
+		bool useGreedyMeshing;
+		uint32_t meshingWorkerCount;
+		uint32_t generationWorkerCount;
+		size_t meshUploadBudgetBytes;
+		float meshUploadBudgetMilliseconds;
+		float meshNeighborTimeoutMilliseconds;
 	};
 
 	class View;
@@ -44,6 +54,7 @@ namespace yamc
 		static void windowSizeCallback(GLFWwindow* window, int width, int height);
 		static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset);
 		static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+		static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 	};
 
 }
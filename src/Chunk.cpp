@@ -1,13 +1,281 @@
 #include "Chunk.h"
+#include "ChunkPool.h"
 #include <gl3w.h>
 #include <vector>
 #include <algorithm>
+#include <cstring>
 
 namespace yamc
 {
-	Chunk::Chunk()
+	ChunkSection::ChunkSection(ChunkPool* pool) :
+		pool(pool),
+		indices(nullptr),
+		bitsPerBlock(0)
 	{
-		memset(blocks, 0, MaxWidth * MaxHeight * MaxLength * sizeof(uint32_t));
+		clear();
+	}
+
+	void ChunkSection::clear()
+	{
+		freeIndices();
+		palette.assign(1, 0);
+		nonAirCount = 0;
+	}
+
+	uint64_t* ChunkSection::allocateIndices(uint32_t bits)
+	{
+		if (pool != nullptr) {
+			return pool->allocateIndices(bits);
+		}
+		return new uint64_t[BlockCount * bits / 64];
+	}
+
+	void ChunkSection::freeIndices()
+	{
+		if (indices != nullptr) {
+			if (pool != nullptr) {
+				pool->freeIndices(indices, bitsPerBlock);
+			}
+			else {
+				delete[] indices;
+			}
+		}
+
+		indices = nullptr;
+		bitsPerBlock = 0;
+	}
+
+	uint32_t ChunkSection::getBlockIndex(uint32_t x, uint32_t y, uint32_t z)
+	{
+		return (y * Size + z) * Size + x;
+	}
+
+	uint32_t ChunkSection::getPaletteIndex(uint32_t blockIndex) const
+	{
+		uint32_t entriesPerWord = 64 / bitsPerBlock;
+		uint64_t word = indices[blockIndex / entriesPerWord];
+		uint32_t shift = (blockIndex % entriesPerWord) * bitsPerBlock;
+		uint64_t mask = (1ull << bitsPerBlock) - 1;
+		return (word >> shift) & mask;
+	}
+
+	void ChunkSection::setPaletteIndex(uint32_t blockIndex, uint32_t paletteIndex)
+	{
+		uint32_t entriesPerWord = 64 / bitsPerBlock;
+		uint64_t& word = indices[blockIndex / entriesPerWord];
+		uint32_t shift = (blockIndex % entriesPerWord) * bitsPerBlock;
+		uint64_t mask = ((1ull << bitsPerBlock) - 1) << shift;
+		word = (word & ~mask) | (((uint64_t)paletteIndex << shift) & mask);
+	}
+
+	uint32_t ChunkSection::findOrAddPaletteEntry(uint32_t value)
+	{
+		for (uint32_t i = 0; i < palette.size(); i++) {
+			if (palette[i] == value) {
+				return i;
+			}
+		}
+
+		palette.push_back(value);
+
+		uint32_t requiredBits = (std::max)(bitsPerBlock, 1u);
+		while ((1ull << requiredBits) < palette.size()) {
+			requiredBits *= 2;
+		}
+		if (requiredBits != bitsPerBlock) {
+			widenIndices(requiredBits);
+		}
+
+		return palette.size() - 1;
+	}
+
+	void ChunkSection::widenIndices(uint32_t newBitsPerBlock)
+	{
+		uint64_t* newIndices = allocateIndices(newBitsPerBlock);
+		uint32_t wordCount = BlockCount * newBitsPerBlock / 64;
+
+		if (bitsPerBlock > 0) {
+			uint32_t entriesPerWord = 64 / newBitsPerBlock;
+			for (uint32_t i = 0; i < wordCount; i++) {
+				uint64_t word = 0;
+				for (uint32_t j = 0; j < entriesPerWord; j++) {
+					word |= (uint64_t)getPaletteIndex(i * entriesPerWord + j) << (j * newBitsPerBlock);
+				}
+				newIndices[i] = word;
+			}
+		}
+		else {
+			memset(newIndices, 0, wordCount * sizeof(uint64_t));
+		}
+
+		freeIndices();
+		indices = newIndices;
+		bitsPerBlock = newBitsPerBlock;
+	}
+
+	uint32_t ChunkSection::getBlock(uint32_t x, uint32_t y, uint32_t z) const
+	{
+		if (bitsPerBlock == 0) {
+			return palette[0];
+		}
+		return palette[getPaletteIndex(getBlockIndex(x, y, z))];
+	}
+
+	void ChunkSection::setBlock(uint32_t x, uint32_t y, uint32_t z, uint32_t value)
+	{
+		uint32_t previousValue = getBlock(x, y, z);
+		if (previousValue == value) {
+			return;
+		}
+
+		if (previousValue == 0) {
+			nonAirCount++;
+		}
+		else if (value == 0) {
+			nonAirCount--;
+		}
+
+		uint32_t paletteIndex = findOrAddPaletteEntry(value);
+		setPaletteIndex(getBlockIndex(x, y, z), paletteIndex);
+	}
+
+	uint32_t ChunkSection::getNonAirCount() const
+	{
+		return nonAirCount;
+	}
+
+	void ChunkSection::unpack(uint32_t* blocks) const
+	{
+		if (bitsPerBlock == 0) {
+			std::fill(blocks, blocks + BlockCount, palette[0]);
+			return;
+		}
+
+		uint32_t entriesPerWord = 64 / bitsPerBlock;
+		uint32_t wordCount = BlockCount / entriesPerWord;
+		uint64_t mask = (1ull << bitsPerBlock) - 1;
+		for (uint32_t i = 0; i < wordCount; i++) {
+			uint64_t word = indices[i];
+			for (uint32_t j = 0; j < entriesPerWord; j++) {
+				*blocks++ = palette[word & mask];
+				word >>= bitsPerBlock;
+			}
+		}
+	}
+
+	void ChunkSection::serialize(std::vector<uint8_t>& dst) const
+	{
+		uint32_t paletteSize = palette.size();
+		size_t paletteBytes = paletteSize * sizeof(uint32_t);
+		size_t indicesBytes = BlockCount * bitsPerBlock / 8;
+
+		size_t offset = dst.size();
+		dst.resize(offset + 1 + sizeof(uint32_t) + paletteBytes + indicesBytes);
+		uint8_t* ptr = dst.data() + offset;
+
+		*ptr++ = (uint8_t)bitsPerBlock;
+		memcpy(ptr, &paletteSize, sizeof(uint32_t));
+		ptr += sizeof(uint32_t);
+		memcpy(ptr, palette.data(), paletteBytes);
+		ptr += paletteBytes;
+		if (indicesBytes > 0) {
+			memcpy(ptr, indices, indicesBytes);
+		}
+	}
+
+	bool ChunkSection::deserialize(const uint8_t*& src, const uint8_t* end)
+	{
+		if ((size_t)(end - src) < 1 + sizeof(uint32_t)) {
+			return false;
+		}
+
+		uint32_t bits = *src++;
+		if (bits > MaxBitsPerBlock || (bits & (bits - 1)) != 0) {
+			return false;
+		}
+
+		uint32_t paletteSize = 0;
+		memcpy(&paletteSize, src, sizeof(uint32_t));
+		src += sizeof(uint32_t);
+
+		size_t paletteBytes = (size_t)paletteSize * sizeof(uint32_t);
+		size_t indicesBytes = bits > 0 ? BlockCount * bits / 8 : 0;
+		if (paletteSize == 0 || (bits < MaxBitsPerBlock && paletteSize > (1ull << bits)) ||
+			(size_t)(end - src) < paletteBytes + indicesBytes) {
+			return false;
+		}
+
+		freeIndices();
+		palette.resize(paletteSize);
+		memcpy(palette.data(), src, paletteBytes);
+		src += paletteBytes;
+
+		if (bits > 0) {
+			indices = allocateIndices(bits);
+			memcpy(indices, src, indicesBytes);
+			src += indicesBytes;
+		}
+		bitsPerBlock = bits;
+
+		nonAirCount = 0;
+		for (uint32_t i = 0; i < BlockCount; i++) {
+			uint32_t paletteIndex = bitsPerBlock > 0 ? getPaletteIndex(i) : 0;
+			if (paletteIndex >= paletteSize) {
+				clear();
+				return false;
+			}
+			if (palette[paletteIndex] != 0) {
+				nonAirCount++;
+			}
+		}
+
+		return true;
+	}
+
+	size_t ChunkSection::getMemoryUsage() const
+	{
+		return sizeof(ChunkSection) + palette.capacity() * sizeof(uint32_t) + BlockCount * bitsPerBlock / 8;
+	}
+
+	ChunkSection::~ChunkSection()
+	{
+		freeIndices();
+	}
+
+	Chunk::Chunk(ChunkPool* pool) :
+		pool(pool)
+	{
+		for (uint32_t i = 0; i < SectionCount; i++) {
+			sections[i] = nullptr;
+		}
+	}
+
+	void Chunk::clear()
+	{
+		for (uint32_t i = 0; i < SectionCount; i++) {
+			if (sections[i] != nullptr) {
+				destroySection(sections[i]);
+				sections[i] = nullptr;
+			}
+		}
+	}
+
+	ChunkSection* Chunk::createSection()
+	{
+		if (pool != nullptr) {
+			return pool->acquireSection();
+		}
+		return new ChunkSection();
+	}
+
+	void Chunk::destroySection(ChunkSection* section)
+	{
+		if (pool != nullptr) {
+			pool->releaseSection(section);
+		}
+		else {
+			delete section;
+		}
 	}
 
 	bool Chunk::isFaceVisible(int x, int y, int z, const glm::ivec3& normal) const
@@ -16,36 +284,138 @@ namespace yamc
 		y += normal.y;
 		z += normal.z;
 
-		if (x < 0 || x >= MaxWidth || 
-			y < 0 || y >= MaxHeight || 
-			z < 0 || z >= MaxLength) {
+		if (x < 0 || x >= (int)MaxWidth ||
+			y < 0 || y >= (int)MaxHeight ||
+			z < 0 || z >= (int)MaxLength) {
 			return true;
 		}
 
-		return blocks[x][y][z] == 0;
+		return getBlock(x, y, z) == 0;
 	}
 
 	uint32_t Chunk::getBlock(uint32_t x, uint32_t y, uint32_t z) const
 	{
-		return blocks[x][y][z];
+		const ChunkSection* section = sections[y / SectionHeight];
+		if (section == nullptr) {
+			return 0;
+		}
+		return section->getBlock(x, y % SectionHeight, z);
 	}
 
 	void Chunk::setBlock(uint32_t x, uint32_t y, uint32_t z, uint32_t value)
 	{
-		blocks[x][y][z] = value;
+		ChunkSection*& section = sections[y / SectionHeight];
+		if (section == nullptr) {
+			if (value == 0) {
+				return;
+			}
+			section = createSection();
+		}
+
+		section->setBlock(x, y % SectionHeight, z, value);
+
+		if (section->getNonAirCount() == 0) {
+			destroySection(section);
+			section = nullptr;
+		}
+	}
+
+	const ChunkSection* Chunk::getSection(uint32_t index) const
+	{
+		return sections[index];
+	}
+
+	void Chunk::serialize(std::vector<uint8_t>& dst) const
+	{
+		uint8_t sectionMask = 0;
+		for (uint32_t i = 0; i < SectionCount; i++) {
+			if (sections[i] != nullptr) {
+				sectionMask |= 1 << i;
+			}
+		}
+
+		dst.clear();
+		dst.push_back(SerializationVersion);
+		dst.push_back(sectionMask);
+
+		for (uint32_t i = 0; i < SectionCount; i++) {
+			if (sections[i] != nullptr) {
+				sections[i]->serialize(dst);
+			}
+		}
+	}
+
+	bool Chunk::deserialize(const void* src, size_t size)
+	{
+		if (size == BlockCount * sizeof(uint32_t)) {
+			return deserializeLegacy(src);
+		}
+
+		const uint8_t* ptr = (const uint8_t*)src;
+		const uint8_t* end = ptr + size;
+
+		if (size < 2 || ptr[0] != SerializationVersion) {
+			return false;
+		}
+
+		uint8_t sectionMask = ptr[1];
+		ptr += 2;
+
+		clear();
+		for (uint32_t i = 0; i < SectionCount; i++) {
+			if ((sectionMask & (1 << i)) == 0) {
+				continue;
+			}
+
+			sections[i] = createSection();
+			if (!sections[i]->deserialize(ptr, end)) {
+				clear();
+				return false;
+			}
+
+			if (sections[i]->getNonAirCount() == 0) {
+				destroySection(sections[i]);
+				sections[i] = nullptr;
+			}
+		}
+
+		if (ptr != end) {
+			clear();
+			return false;
+		}
+
+		return true;
 	}
 
-	const void* Chunk::getData() const
+	bool Chunk::deserializeLegacy(const void* src)
 	{
-		return &blocks[0][0][0];
+		const uint32_t* blocks = (const uint32_t*)src;
+
+		clear();
+		for (uint32_t x = 0; x < MaxWidth; x++) {
+			for (uint32_t y = 0; y < MaxHeight; y++) {
+				for (uint32_t z = 0; z < MaxLength; z++) {
+					setBlock(x, y, z, *blocks++);
+				}
+			}
+		}
+
+		return true;
 	}
 
-	void* Chunk::getData()
+	size_t Chunk::getMemoryUsage() const
 	{
-		return &blocks[0][0][0];
+		size_t size = sizeof(Chunk);
+		for (uint32_t i = 0; i < SectionCount; i++) {
+			if (sections[i] != nullptr) {
+				size += sections[i]->getMemoryUsage();
+			}
+		}
+		return size;
 	}
 
 	Chunk::~Chunk()
 	{
+		clear();
 	}
 }
\ No newline at end of file
@@ -2,31 +2,86 @@
 #define YAMC_CHUNK_H
 
 #include <stdint.h>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace yamc
 {
+	class ChunkPool;
+
+	class ChunkSection
+	{
+	public:
+		static constexpr uint32_t Size = 16;
+		static constexpr uint32_t BlockCount = Size * Size * Size;
+
+		ChunkSection(ChunkPool* pool = nullptr);
+		ChunkSection(const ChunkSection&) = delete;
+		ChunkSection(ChunkSection&&) = delete;
+
+		uint32_t getBlock(uint32_t x, uint32_t y, uint32_t z) const;
+		void setBlock(uint32_t x, uint32_t y, uint32_t z, uint32_t value);
+		uint32_t getNonAirCount() const;
+		void unpack(uint32_t* blocks) const;
+		void clear();
+		void serialize(std::vector<uint8_t>& dst) const;
+		bool deserialize(const uint8_t*& src, const uint8_t* end);
+		size_t getMemoryUsage() const;
+
+		~ChunkSection();
+
+	private:
+		static constexpr uint32_t MaxBitsPerBlock = 32;
+
+		ChunkPool* pool;
+		std::vector<uint32_t> palette;
+		uint64_t* indices;
+		uint32_t bitsPerBlock;
+		uint32_t nonAirCount;
+
+		static uint32_t getBlockIndex(uint32_t x, uint32_t y, uint32_t z);
+		uint32_t getPaletteIndex(uint32_t blockIndex) const;
+		void setPaletteIndex(uint32_t blockIndex, uint32_t paletteIndex);
+		uint32_t findOrAddPaletteEntry(uint32_t value);
+		void widenIndices(uint32_t newBitsPerBlock);
+		uint64_t* allocateIndices(uint32_t bits);
+		void freeIndices();
+	};
+
 	class Chunk
 	{
 	public:
 		static constexpr uint32_t MaxWidth = 16;
 		static constexpr uint32_t MaxLength = 16;
 		static constexpr uint32_t MaxHeight = 128;
+		static constexpr uint32_t BlockCount = MaxWidth * MaxHeight * MaxLength;
+		static constexpr uint32_t SectionHeight = ChunkSection::Size;
+		static constexpr uint32_t SectionCount = MaxHeight / SectionHeight;
+		static constexpr uint8_t AllSectionsMask = (1 << SectionCount) - 1;
 
-		Chunk();
+		Chunk(ChunkPool* pool = nullptr);
 		Chunk(const Chunk&) = delete;
 		Chunk(Chunk&&) = delete;
 
 		uint32_t getBlock(uint32_t x, uint32_t y, uint32_t z) const;
 		void setBlock(uint32_t x, uint32_t y, uint32_t z, uint32_t value);
-		const void* getData() const;
-		void* getData();
+		const ChunkSection* getSection(uint32_t index) const;
+		void serialize(std::vector<uint8_t>& dst) const;
+		bool deserialize(const void* src, size_t size);
+		size_t getMemoryUsage() const;
+		void clear();
 
 		~Chunk();
 
 	private:
-		uint32_t blocks[MaxWidth][MaxHeight][MaxLength];
+		static constexpr uint8_t SerializationVersion = 2;
+
+		ChunkPool* pool;
+		ChunkSection* sections[SectionCount];
 
+		ChunkSection* createSection();
+		void destroySection(ChunkSection* section);
+		bool deserializeLegacy(const void* src);
 		bool isFaceVisible(int x, int y, int z, const glm::ivec3& normal) const;
 	};
 }
@@ -0,0 +1,316 @@
+#include "ChunkBufferArena.h"
+#include <gl3w.h>
+#include <iterator>
+#include <stdexcept>
+
+namespace yamc
+{
+	RangeAllocator::RangeAllocator(uint32_t capacity) :
+		capacity(capacity),
+		usedSize(0)
+	{
+		freeRanges[0] = capacity;
+	}
+
+	bool RangeAllocator::allocate(uint32_t size, uint32_t& offset)
+	{
+		for (auto it = freeRanges.begin(); it != freeRanges.end(); it++) {
+			if (it->second < size) {
+				continue;
+			}
+
+			offset = it->first;
+			uint32_t remainingSize = it->second - size;
+			freeRanges.erase(it);
+			if (remainingSize > 0) {
+				freeRanges[offset + size] = remainingSize;
+			}
+
+			usedSize += size;
+			return true;
+		}
+		return false;
+	}
+
+	void RangeAllocator::free(uint32_t offset, uint32_t size)
+	{
+		usedSize -= size;
+
+		auto next = freeRanges.lower_bound(offset);
+		if (next != freeRanges.end() && offset + size == next->first) {
+			size += next->second;
+			next = freeRanges.erase(next);
+		}
+
+		if (next != freeRanges.begin()) {
+			auto previous = std::prev(next);
+			if (previous->first + previous->second == offset) {
+				previous->second += size;
+				return;
+			}
+		}
+
+		freeRanges[offset] = size;
+	}
+
+	void RangeAllocator::grow(uint32_t newCapacity)
+	{
+		uint32_t oldCapacity = capacity;
+		capacity = newCapacity;
+		usedSize += newCapacity - oldCapacity;
+		free(oldCapacity, newCapacity - oldCapacity);
+	}
+
+	uint32_t RangeAllocator::getCapacity() const
+	{
+		return capacity;
+	}
+
+	uint32_t RangeAllocator::getUsedSize() const
+	{
+		return usedSize;
+	}
+
+	uint32_t RangeAllocator::getFreeRangeCount() const
+	{
+		return freeRanges.size();
+	}
+
+	uint32_t RangeAllocator::getLargestFreeRange() const
+	{
+		uint32_t largestRange = 0;
+		for (auto& range : freeRanges) {
+			largestRange = (std::max)(largestRange, range.second);
+		}
+		return largestRange;
+	}
+
+	ChunkBufferArena::ChunkBufferArena() :
+		vertexAllocator(InitialVertexCapacity),
+		indexAllocator(InitialIndexCapacity),
+		nextSlot(1),
+		chunkCount(0)
+	{
+		glGenVertexArrays(1, &vaoID);
+		glGenBuffers(1, &vertexBufferID);
+		glGenBuffers(1, &indexBufferID);
+		glGenBuffers(1, &chunkOffsetsBufferID);
+		glGenTextures(1, &chunkOffsetsTextureID);
+
+		glBindVertexArray(vaoID);
+
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBufferID);
+		glBufferData(GL_ARRAY_BUFFER, InitialVertexCapacity * sizeof(glm::uvec2), nullptr, GL_STATIC_DRAW);
+		glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(glm::uvec2), (void*)0);
+		glEnableVertexAttribArray(0);
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, InitialIndexCapacity * sizeof(uint32_t), nullptr, GL_STATIC_DRAW);
+
+		glBindVertexArray(0);
+
+		glBindBuffer(GL_TEXTURE_BUFFER, chunkOffsetsBufferID);
+		glBufferData(GL_TEXTURE_BUFFER, MaxSlots * sizeof(glm::ivec2), nullptr, GL_DYNAMIC_DRAW);
+		glBindTexture(GL_TEXTURE_BUFFER, chunkOffsetsTextureID);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32I, chunkOffsetsBufferID);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	}
+
+	void ChunkBufferArena::growBuffer(uint32_t& bufferID, uint32_t target, size_t oldSize, size_t newSize)
+	{
+		uint32_t newBufferID = 0;
+		glGenBuffers(1, &newBufferID);
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, newBufferID);
+		glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_STATIC_DRAW);
+		glBindBuffer(GL_COPY_READ_BUFFER, bufferID);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		glDeleteBuffers(1, &bufferID);
+		bufferID = newBufferID;
+
+		glBindVertexArray(vaoID);
+		glBindBuffer(target, bufferID);
+		if (target == GL_ARRAY_BUFFER) {
+			glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(glm::uvec2), (void*)0);
+		}
+		glBindVertexArray(0);
+	}
+
+	uint32_t ChunkBufferArena::allocateVertices(uint32_t count)
+	{
+		uint32_t offset = 0;
+		while (!vertexAllocator.allocate(count, offset)) {
+			uint32_t oldCapacity = vertexAllocator.getCapacity();
+			growBuffer(vertexBufferID, GL_ARRAY_BUFFER, oldCapacity * sizeof(glm::uvec2), oldCapacity * 2 * sizeof(glm::uvec2));
+			vertexAllocator.grow(oldCapacity * 2);
+		}
+		return offset;
+	}
+
+	uint32_t ChunkBufferArena::allocateIndices(uint32_t count)
+	{
+		uint32_t offset = 0;
+		while (!indexAllocator.allocate(count, offset)) {
+			uint32_t oldCapacity = indexAllocator.getCapacity();
+			growBuffer(indexBufferID, GL_ELEMENT_ARRAY_BUFFER, oldCapacity * sizeof(uint32_t), oldCapacity * 2 * sizeof(uint32_t));
+			indexAllocator.grow(oldCapacity * 2);
+		}
+		return offset;
+	}
+
+	void ChunkBufferArena::upload(ChunkAllocation& allocation, int chunkX, int chunkZ, std::vector<glm::uvec2>& vertices, const std::vector<uint32_t>& indices)
+	{
+		if (allocation.vertexCount > 0) {
+			vertexAllocator.free(allocation.vertexOffset, allocation.vertexCount);
+			indexAllocator.free(allocation.indexOffset, allocation.indexCount);
+		}
+
+		if (allocation.slot == 0) {
+			assignSlot(allocation, chunkX, chunkZ);
+		}
+
+		allocation.vertexCount = vertices.size();
+		allocation.indexCount = indices.size();
+		if (vertices.empty()) {
+			allocation.vertexOffset = 0;
+			allocation.indexOffset = 0;
+			return;
+		}
+
+		stampSlot(allocation.slot, vertices);
+
+		allocation.vertexOffset = allocateVertices(allocation.vertexCount);
+		allocation.indexOffset = allocateIndices(allocation.indexCount);
+
+		stagingRing.upload(vertexBufferID, allocation.vertexOffset * sizeof(glm::uvec2), vertices.data(), vertices.size() * sizeof(glm::uvec2));
+		stagingRing.upload(indexBufferID, allocation.indexOffset * sizeof(uint32_t), indices.data(), indices.size() * sizeof(uint32_t));
+		stagingRing.fence();
+	}
+
+	void ChunkBufferArena::patch(ChunkAllocation& allocation, const std::vector<ChunkVertexSpan>& spans, std::vector<glm::uvec2>& vertices, const std::vector<uint32_t>& indices)
+	{
+		uint32_t vertexCount = 0;
+		for (auto& span : spans) {
+			vertexCount += span.count;
+		}
+
+		stampSlot(allocation.slot, vertices);
+
+		uint32_t vertexOffset = vertexCount > 0 ? allocateVertices(vertexCount) : 0;
+		uint32_t indexOffset = !indices.empty() ? allocateIndices(indices.size()) : 0;
+
+		uint32_t destination = vertexOffset;
+		for (auto& span : spans) {
+			if (span.count == 0) {
+				continue;
+			}
+
+			if (span.isUploaded) {
+				stagingRing.upload(vertexBufferID, destination * sizeof(glm::uvec2), vertices.data() + span.offset, span.count * sizeof(glm::uvec2));
+			}
+			else {
+				glBindBuffer(GL_COPY_READ_BUFFER, vertexBufferID);
+				glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBufferID);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (allocation.vertexOffset + span.offset) * sizeof(glm::uvec2), destination * sizeof(glm::uvec2), span.count * sizeof(glm::uvec2));
+				glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+				glBindBuffer(GL_COPY_READ_BUFFER, 0);
+			}
+			destination += span.count;
+		}
+
+		stagingRing.upload(indexBufferID, indexOffset * sizeof(uint32_t), indices.data(), indices.size() * sizeof(uint32_t));
+		stagingRing.fence();
+
+		if (allocation.vertexCount > 0) {
+			vertexAllocator.free(allocation.vertexOffset, allocation.vertexCount);
+			indexAllocator.free(allocation.indexOffset, allocation.indexCount);
+		}
+
+		allocation.vertexOffset = vertexOffset;
+		allocation.vertexCount = vertexCount;
+		allocation.indexOffset = indexOffset;
+		allocation.indexCount = indices.size();
+	}
+
+	void ChunkBufferArena::assignSlot(ChunkAllocation& allocation, int chunkX, int chunkZ)
+	{
+		if (!freeSlots.empty()) {
+			allocation.slot = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else if (nextSlot < MaxSlots) {
+			allocation.slot = nextSlot++;
+		}
+		else {
+			throw std::runtime_error("Chunk buffer arena is out of slots.");
+		}
+		chunkCount++;
+
+		glm::ivec2 chunkOffset(chunkX, chunkZ);
+		glBindBuffer(GL_TEXTURE_BUFFER, chunkOffsetsBufferID);
+		glBufferSubData(GL_TEXTURE_BUFFER, allocation.slot * sizeof(glm::ivec2), sizeof(glm::ivec2), &chunkOffset);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	}
+
+	void ChunkBufferArena::stampSlot(uint32_t slot, std::vector<glm::uvec2>& vertices)
+	{
+		for (auto& vertex : vertices) {
+			vertex.x |= (slot & ((1 << SlotLowBits) - 1)) << 23;
+			vertex.y |= (slot >> SlotLowBits) << 26;
+		}
+	}
+
+	void ChunkBufferArena::release(ChunkAllocation& allocation)
+	{
+		if (allocation.vertexCount > 0) {
+			vertexAllocator.free(allocation.vertexOffset, allocation.vertexCount);
+			indexAllocator.free(allocation.indexOffset, allocation.indexCount);
+		}
+
+		if (allocation.slot != 0) {
+			freeSlots.push_back(allocation.slot);
+			chunkCount--;
+		}
+
+		allocation = {};
+	}
+
+	uint32_t ChunkBufferArena::getVAO() const
+	{
+		return vaoID;
+	}
+
+	uint32_t ChunkBufferArena::getChunkOffsetsTextureID() const
+	{
+		return chunkOffsetsTextureID;
+	}
+
+	ChunkBufferArenaStats ChunkBufferArena::getStats() const
+	{
+		ChunkBufferArenaStats stats;
+		stats.vertexCapacity = vertexAllocator.getCapacity();
+		stats.vertexUsed = vertexAllocator.getUsedSize();
+		stats.vertexFreeRanges = vertexAllocator.getFreeRangeCount();
+		stats.largestFreeVertexRange = vertexAllocator.getLargestFreeRange();
+		stats.indexCapacity = indexAllocator.getCapacity();
+		stats.indexUsed = indexAllocator.getUsedSize();
+		stats.indexFreeRanges = indexAllocator.getFreeRangeCount();
+		stats.largestFreeIndexRange = indexAllocator.getLargestFreeRange();
+		stats.chunkCount = chunkCount;
+		stats.stagingStalls = stagingRing.getStallCount();
+		return stats;
+	}
+
+	ChunkBufferArena::~ChunkBufferArena()
+	{
+		glDeleteTextures(1, &chunkOffsetsTextureID);
+		glDeleteBuffers(1, &chunkOffsetsBufferID);
+		glDeleteBuffers(1, &indexBufferID);
+		glDeleteBuffers(1, &vertexBufferID);
+		glDeleteVertexArrays(1, &vaoID);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef YAMC_CHUNK_BUFFER_ARENA_H
+#define YAMC_CHUNK_BUFFER_ARENA_H
+
+#include "StagingRing.h"
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include <glm/glm.hpp>
+
+namespace yamc
+{
+	class RangeAllocator
+	{
+	public:
+		RangeAllocator(uint32_t capacity);
+
+		bool allocate(uint32_t size, uint32_t& offset);
+		void free(uint32_t offset, uint32_t size);
+		void grow(uint32_t newCapacity);
+
+		uint32_t getCapacity() const;
+		uint32_t getUsedSize() const;
+		uint32_t getFreeRangeCount() const;
+		uint32_t getLargestFreeRange() const;
+
+	private:
+		std::map<uint32_t, uint32_t> freeRanges;
+		uint32_t capacity;
+		uint32_t usedSize;
+	};
+
+	struct ChunkAllocation
+	{
+		uint32_t slot;
+		uint32_t vertexOffset;
+		uint32_t vertexCount;
+		uint32_t indexOffset;
+		uint32_t indexCount;
+	};
+
+	struct ChunkVertexSpan
+	{
+		uint32_t offset;
+		uint32_t count;
+		bool isUploaded;
+	};
+
+	struct ChunkBufferArenaStats
+	{
+		uint32_t vertexCapacity;
+		uint32_t vertexUsed;
+		uint32_t vertexFreeRanges;
+		uint32_t largestFreeVertexRange;
+		uint32_t indexCapacity;
+		uint32_t indexUsed;
+		uint32_t indexFreeRanges;
+		uint32_t largestFreeIndexRange;
+		uint32_t chunkCount;
+		uint32_t stagingStalls;
+	};
+
+	class ChunkBufferArena
+	{
+	public:
+		static constexpr uint32_t MaxSlots = 1 << 15;
+		static constexpr uint32_t SlotLowBits = 9;
+		static constexpr uint32_t InitialVertexCapacity = 1 << 20;
+		static constexpr uint32_t InitialIndexCapacity = 3 << 19;
+
+		ChunkBufferArena();
+		ChunkBufferArena(const ChunkBufferArena&) = delete;
+
+		void upload(ChunkAllocation& allocation, int chunkX, int chunkZ, std::vector<glm::uvec2>& vertices, const std::vector<uint32_t>& indices);
+		void patch(ChunkAllocation& allocation, const std::vector<ChunkVertexSpan>& spans, std::vector<glm::uvec2>& vertices, const std::vector<uint32_t>& indices);
+		void release(ChunkAllocation& allocation);
+
+		uint32_t getVAO() const;
+		uint32_t getChunkOffsetsTextureID() const;
+		ChunkBufferArenaStats getStats() const;
+
+		~ChunkBufferArena();
+
+	private:
+		uint32_t vaoID;
+		uint32_t vertexBufferID;
+		uint32_t indexBufferID;
+		uint32_t chunkOffsetsBufferID;
+		uint32_t chunkOffsetsTextureID;
+		RangeAllocator vertexAllocator;
+		RangeAllocator indexAllocator;
+		StagingRing stagingRing;
+		std::vector<uint32_t> freeSlots;
+		uint32_t nextSlot;
+		uint32_t chunkCount;
+
+		uint32_t allocateVertices(uint32_t count);
+		uint32_t allocateIndices(uint32_t count);
+		void assignSlot(ChunkAllocation& allocation, int chunkX, int chunkZ);
+		static void stampSlot(uint32_t slot, std::vector<glm::uvec2>& vertices);
+		void growBuffer(uint32_t& bufferID, uint32_t target, size_t oldSize, size_t newSize);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "ChunkGenerationQueue.h"
+#include <limits>
+
+namespace yamc
+{
+	ChunkGenerationQueue::ChunkGenerationQueue() :
+		isStopping(false),
+		focusPosition(0, 0, 0),
+		viewDirection(0, 0),
+		minChunk((std::numeric_limits<int>::min)()),
+		maxChunk((std::numeric_limits<int>::max)()),
+		stats()
+	{
+	}
+
+	void ChunkGenerationQueue::setFocus(const glm::vec3& position, const glm::vec3& viewDirection)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		focusPosition = position;
+
+		glm::vec2 horizontalDirection(viewDirection.x, viewDirection.z);
+		float length = glm::length(horizontalDirection);
+		this->viewDirection = length > 0.0001f ? horizontalDirection / length : glm::vec2(0, 0);
+	}
+
+	void ChunkGenerationQueue::setBounds(const glm::ivec2& minChunk, const glm::ivec2& maxChunk)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		this->minChunk = minChunk;
+		this->maxChunk = maxChunk;
+
+		for (auto it = pendingKeys.begin(); it != pendingKeys.end();) {
+			if (!isInBoundsLocked(*it)) {
+				it = pendingKeys.erase(it);
+				stats.requestsCancelled++;
+			}
+			else {
+				it++;
+			}
+		}
+	}
+
+	void ChunkGenerationQueue::request(uint64_t chunkKey)
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			if (!requestLocked(chunkKey)) {
+				return;
+			}
+		}
+		hasPendingKeys.notify_one();
+	}
+
+	void ChunkGenerationQueue::request(const std::vector<uint64_t>& chunkKeys)
+	{
+		size_t queuedCount = 0;
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			for (uint64_t chunkKey : chunkKeys) {
+				if (requestLocked(chunkKey)) {
+					queuedCount++;
+				}
+			}
+		}
+
+		if (queuedCount == 1) {
+			hasPendingKeys.notify_one();
+		}
+		else if (queuedCount > 1) {
+			hasPendingKeys.notify_all();
+		}
+	}
+
+	bool ChunkGenerationQueue::requestLocked(uint64_t chunkKey)
+	{
+		if (!isInBoundsLocked(chunkKey)) {
+			return false;
+		}
+
+		if (inFlightKeys.count(chunkKey) > 0 || !pendingKeys.insert(chunkKey).second) {
+			stats.duplicatesAvoided++;
+			return false;
+		}
+
+		pendingPrefetchKeys.erase(chunkKey);
+		stats.requestsQueued++;
+		return true;
+	}
+
+	void ChunkGenerationQueue::setPrefetchKeys(const std::vector<uint64_t>& chunkKeys)
+	{
+		size_t queuedCount = 0;
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			prefetchKeys.clear();
+			previousPendingPrefetchKeys.swap(pendingPrefetchKeys);
+			pendingPrefetchKeys.clear();
+			for (uint64_t chunkKey : chunkKeys) {
+				prefetchKeys.insert(chunkKey);
+				if (pendingKeys.count(chunkKey) == 0 && inFlightKeys.count(chunkKey) == 0) {
+					pendingPrefetchKeys.insert(chunkKey);
+					if (previousPendingPrefetchKeys.count(chunkKey) == 0) {
+						queuedCount++;
+					}
+				}
+			}
+			previousPendingPrefetchKeys.clear();
+			stats.prefetchesQueued += queuedCount;
+		}
+
+		if (queuedCount > 0) {
+			hasPendingKeys.notify_all();
+		}
+	}
+
+	float ChunkGenerationQueue::getPriority(uint64_t chunkKey) const
+	{
+		auto offset = getChunkOffset(chunkKey);
+		glm::vec2 center((offset[0] + 0.5f) * Chunk::MaxWidth, (offset[1] + 0.5f) * Chunk::MaxLength);
+		glm::vec2 delta = center - glm::vec2(focusPosition.x, focusPosition.z);
+		float distance = glm::length(delta);
+		if (distance < 0.0001f) {
+			return 0.0f;
+		}
+
+		float alignment = glm::dot(delta / distance, viewDirection);
+		return distance * (1.0f + ViewDirectionWeight * (1.0f - alignment));
+	}
+
+	bool ChunkGenerationQueue::waitForNearestKey(uint64_t& chunkKey)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		hasPendingKeys.wait(lock, [this] { return isStopping || !pendingKeys.empty() || !pendingPrefetchKeys.empty(); });
+		if (isStopping) {
+			return false;
+		}
+
+		chunkKey = takeNearestKey(pendingKeys.empty() ? pendingPrefetchKeys : pendingKeys);
+		inFlightKeys.insert(chunkKey);
+		return true;
+	}
+
+	uint64_t ChunkGenerationQueue::takeNearestKey(std::unordered_set<uint64_t>& keys)
+	{
+		uint64_t chunkKey = 0;
+		float minPriority = (std::numeric_limits<float>::max)();
+		for (uint64_t key : keys) {
+			float priority = getPriority(key);
+			if (priority < minPriority) {
+				minPriority = priority;
+				chunkKey = key;
+			}
+		}
+
+		keys.erase(chunkKey);
+		return chunkKey;
+	}
+
+	bool ChunkGenerationQueue::isInBounds(uint64_t chunkKey) const
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return isInBoundsLocked(chunkKey);
+	}
+
+	bool ChunkGenerationQueue::isPrefetchKey(uint64_t chunkKey) const
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return prefetchKeys.count(chunkKey) > 0;
+	}
+
+	bool ChunkGenerationQueue::isInBoundsLocked(uint64_t chunkKey) const
+	{
+		auto offset = getChunkOffset(chunkKey);
+		return offset[0] >= minChunk.x && offset[0] <= maxChunk.x && offset[1] >= minChunk.y && offset[1] <= maxChunk.y;
+	}
+
+	void ChunkGenerationQueue::finish(uint64_t chunkKey)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		inFlightKeys.erase(chunkKey);
+	}
+
+	void ChunkGenerationQueue::stop()
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			isStopping = true;
+			pendingKeys.clear();
+			pendingPrefetchKeys.clear();
+		}
+		hasPendingKeys.notify_all();
+	}
+
+	size_t ChunkGenerationQueue::getPendingCount() const
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return pendingKeys.size() + pendingPrefetchKeys.size() + inFlightKeys.size();
+	}
+
+	ChunkGenerationQueueStats ChunkGenerationQueue::getStats() const
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return stats;
+	}
+}
\ No newline at end of file
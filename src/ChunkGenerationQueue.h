@@ -0,0 +1,65 @@
+#ifndef YAMC_CHUNK_GENERATION_QUEUE_H
+#define YAMC_CHUNK_GENERATION_QUEUE_H
+
+#include "Terrain.h"
+#include <glm/glm.hpp>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_set>
+#include <vector>
+
+namespace yamc
+{
+	struct ChunkGenerationQueueStats
+	{
+		uint64_t requestsQueued;
+		uint64_t duplicatesAvoided;
+		uint64_t requestsCancelled;
+		uint64_t prefetchesQueued;
+	};
+
+	class ChunkGenerationQueue
+	{
+	public:
+		static constexpr float ViewDirectionWeight = 0.5f;
+
+		ChunkGenerationQueue();
+		ChunkGenerationQueue(const ChunkGenerationQueue&) = delete;
+		ChunkGenerationQueue(ChunkGenerationQueue&&) = delete;
+
+		void setFocus(const glm::vec3& position, const glm::vec3& viewDirection);
+		void setBounds(const glm::ivec2& minChunk, const glm::ivec2& maxChunk);
+		void request(uint64_t chunkKey);
+		void request(const std::vector<uint64_t>& chunkKeys);
+		void setPrefetchKeys(const std::vector<uint64_t>& chunkKeys);
+		bool waitForNearestKey(uint64_t& chunkKey);
+		bool isInBounds(uint64_t chunkKey) const;
+		bool isPrefetchKey(uint64_t chunkKey) const;
+		void finish(uint64_t chunkKey);
+		void stop();
+		size_t getPendingCount() const;
+		ChunkGenerationQueueStats getStats() const;
+
+	private:
+		mutable std::mutex mutex;
+		std::condition_variable hasPendingKeys;
+		bool isStopping;
+		glm::vec3 focusPosition;
+		glm::vec2 viewDirection;
+		glm::ivec2 minChunk;
+		glm::ivec2 maxChunk;
+		std::unordered_set<uint64_t> pendingKeys;
+		std::unordered_set<uint64_t> inFlightKeys;
+		std::unordered_set<uint64_t> prefetchKeys;
+		std::unordered_set<uint64_t> pendingPrefetchKeys;
+		std::unordered_set<uint64_t> previousPendingPrefetchKeys;
+		ChunkGenerationQueueStats stats;
+
+		bool isInBoundsLocked(uint64_t chunkKey) const;
+		bool requestLocked(uint64_t chunkKey);
+		float getPriority(uint64_t chunkKey) const;
+		uint64_t takeNearestKey(std::unordered_set<uint64_t>& keys);
+	};
+}
+
+#endif
\ No newline at end of file
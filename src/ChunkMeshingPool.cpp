@@ -0,0 +1,205 @@
+#include "ChunkMeshingPool.h"
+#include <algorithm>
+#include <limits>
+
+namespace yamc
+{
+	ChunkMeshingPool::ChunkMeshingPool(Terrain& terrain, std::mutex& terrainMutex) :
+		terrain(terrain),
+		terrainMutex(terrainMutex),
+		meshBuilder(nullptr),
+		isStopping(false),
+		useGreedyMeshing(true),
+		fullDetailRadius((std::numeric_limits<int>::max)()),
+		focusPosition(0, 0, 0),
+		lastVersion(0),
+		stats()
+	{
+	}
+
+	void ChunkMeshingPool::start(const MeshBuilder* meshBuilder, uint32_t workerCount)
+	{
+		this->meshBuilder = meshBuilder;
+		isStopping = false;
+
+		workerCount = (std::max)(workerCount, 1u);
+		for (uint32_t i = 0; i < workerCount; i++) {
+			workers.push_back(std::thread(workerLoop, this));
+		}
+	}
+
+	void ChunkMeshingPool::stop()
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			isStopping = true;
+		}
+		hasPendingKeys.notify_all();
+
+		for (auto& worker : workers) {
+			worker.join();
+		}
+		workers.clear();
+	}
+
+	bool ChunkMeshingPool::isRunning() const
+	{
+		return !workers.empty();
+	}
+
+	void ChunkMeshingPool::setFocus(const glm::vec3& position)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		focusPosition = position;
+	}
+
+	void ChunkMeshingPool::setGreedyMeshingEnabled(bool isEnabled)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		useGreedyMeshing = isEnabled;
+	}
+
+	void ChunkMeshingPool::setFullDetailRadius(int radius)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		fullDetailRadius = radius;
+	}
+
+	void ChunkMeshingPool::request(uint64_t chunkKey)
+	{
+		requestSections(chunkKey, Chunk::AllSectionsMask);
+	}
+
+	void ChunkMeshingPool::requestSections(uint64_t chunkKey, uint8_t sectionMask)
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			requestedVersions[chunkKey] = ++lastVersion;
+			requestedSectionMasks[chunkKey] |= sectionMask;
+			pendingKeys.insert(chunkKey);
+		}
+		hasPendingKeys.notify_one();
+	}
+
+	void ChunkMeshingPool::cancel(uint64_t chunkKey)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		pendingKeys.erase(chunkKey);
+		requestedVersions.erase(chunkKey);
+		requestedSectionMasks.erase(chunkKey);
+	}
+
+	void ChunkMeshingPool::takeResults(std::vector<ChunkMeshResult>& results)
+	{
+		results.clear();
+
+		std::lock_guard<std::mutex> guard(mutex);
+		for (auto& result : completedResults) {
+			auto version = requestedVersions.find(result.chunkKey);
+			if (version == requestedVersions.end() || version->second != result.version) {
+				stats.staleResultsDiscarded++;
+				continue;
+			}
+
+			requestedVersions.erase(version);
+			requestedSectionMasks.erase(result.chunkKey);
+			results.push_back(std::move(result));
+		}
+		completedResults.clear();
+	}
+
+	size_t ChunkMeshingPool::getPendingCount() const
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return pendingKeys.size();
+	}
+
+	ChunkMeshingPoolStats ChunkMeshingPool::getStats() const
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return stats;
+	}
+
+	bool ChunkMeshingPool::isRequestCurrent(uint64_t chunkKey, uint64_t version)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		auto requestedVersion = requestedVersions.find(chunkKey);
+		if (requestedVersion == requestedVersions.end() || requestedVersion->second != version) {
+			stats.staleRequestsSkipped++;
+			return false;
+		}
+		return true;
+	}
+
+	bool ChunkMeshingPool::waitForNearestKey(uint64_t& chunkKey, uint64_t& version, bool& useGreedyMeshing, uint32_t& lodLevel, uint8_t& sectionMask)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		hasPendingKeys.wait(lock, [this] { return isStopping || !pendingKeys.empty(); });
+		if (isStopping) {
+			return false;
+		}
+
+		float minDistance = (std::numeric_limits<float>::max)();
+		for (uint64_t key : pendingKeys) {
+			auto offset = getChunkOffset(key);
+			glm::vec2 center((offset[0] + 0.5f) * Chunk::MaxWidth, (offset[1] + 0.5f) * Chunk::MaxLength);
+			glm::vec2 delta = center - glm::vec2(focusPosition.x, focusPosition.z);
+			float distance = glm::dot(delta, delta);
+			if (distance < minDistance) {
+				minDistance = distance;
+				chunkKey = key;
+			}
+		}
+
+		pendingKeys.erase(chunkKey);
+		version = requestedVersions[chunkKey];
+		sectionMask = requestedSectionMasks[chunkKey];
+		useGreedyMeshing = this->useGreedyMeshing;
+
+		auto offset = getChunkOffset(chunkKey);
+		int focusChunkX = getChunkIndex((int)floorf(focusPosition.x), Chunk::MaxWidth);
+		int focusChunkZ = getChunkIndex((int)floorf(focusPosition.z), Chunk::MaxLength);
+		int chunkDistance = (std::max)(abs(offset[0] - focusChunkX), abs(offset[1] - focusChunkZ));
+		lodLevel = MeshBuilder::getLodLevel(chunkDistance, fullDetailRadius);
+		return true;
+	}
+
+	void ChunkMeshingPool::workerLoop(ChunkMeshingPool* pool)
+	{
+		ChunkNeighborhood neighborhood;
+		uint64_t chunkKey;
+		uint64_t version;
+		bool useGreedyMeshing;
+		uint32_t lodLevel;
+		uint8_t sectionMask;
+
+		while (pool->waitForNearestKey(chunkKey, version, useGreedyMeshing, lodLevel, sectionMask)) {
+			{
+				std::lock_guard<std::mutex> guard(pool->terrainMutex);
+				if (!pool->terrain.copyNeighborhood(chunkKey, neighborhood)) {
+					continue;
+				}
+			}
+
+			if (!pool->isRequestCurrent(chunkKey, version)) {
+				continue;
+			}
+
+			ChunkMeshResult result;
+			result.chunkKey = chunkKey;
+			result.version = version;
+			pool->meshBuilder->buildChunk(neighborhood, useGreedyMeshing, lodLevel, sectionMask, result.meshData);
+
+			std::lock_guard<std::mutex> guard(pool->mutex);
+			pool->stats.chunksBuilt++;
+			pool->completedResults.push_back(std::move(result));
+		}
+	}
+
+	ChunkMeshingPool::~ChunkMeshingPool()
+	{
+		if (isRunning()) {
+			stop();
+		}
+	}
+}
\ No newline at end of file
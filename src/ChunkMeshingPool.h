@@ -0,0 +1,78 @@
+#ifndef YAMC_CHUNK_MESHING_POOL_H
+#define YAMC_CHUNK_MESHING_POOL_H
+
+#include "Terrain.h"
+#include "MeshBuilder.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace yamc
+{
+	struct ChunkMeshResult
+	{
+		uint64_t chunkKey;
+		uint64_t version;
+		ChunkMeshData meshData;
+	};
+
+	struct ChunkMeshingPoolStats
+	{
+		uint64_t chunksBuilt;
+		uint64_t staleRequestsSkipped;
+		uint64_t staleResultsDiscarded;
+	};
+
+	class ChunkMeshingPool
+	{
+	public:
+		ChunkMeshingPool(Terrain& terrain, std::mutex& terrainMutex);
+		ChunkMeshingPool(const ChunkMeshingPool&) = delete;
+		ChunkMeshingPool(ChunkMeshingPool&&) = delete;
+
+		void start(const MeshBuilder* meshBuilder, uint32_t workerCount);
+		void stop();
+		bool isRunning() const;
+
+		void setFocus(const glm::vec3& position);
+		void setGreedyMeshingEnabled(bool isEnabled);
+		void setFullDetailRadius(int radius);
+		void request(uint64_t chunkKey);
+		void requestSections(uint64_t chunkKey, uint8_t sectionMask);
+		void cancel(uint64_t chunkKey);
+		void takeResults(std::vector<ChunkMeshResult>& results);
+		size_t getPendingCount() const;
+		ChunkMeshingPoolStats getStats() const;
+
+		~ChunkMeshingPool();
+
+	private:
+		Terrain& terrain;
+		std::mutex& terrainMutex;
+		const MeshBuilder* meshBuilder;
+		std::vector<std::thread> workers;
+
+		mutable std::mutex mutex;
+		std::condition_variable hasPendingKeys;
+		bool isStopping;
+		bool useGreedyMeshing;
+		int fullDetailRadius;
+		glm::vec3 focusPosition;
+		uint64_t lastVersion;
+		std::unordered_set<uint64_t> pendingKeys;
+		std::unordered_map<uint64_t, uint64_t> requestedVersions;
+		std::unordered_map<uint64_t, uint8_t> requestedSectionMasks;
+		std::vector<ChunkMeshResult> completedResults;
+		ChunkMeshingPoolStats stats;
+
+		static void workerLoop(ChunkMeshingPool* pool);
+		bool isRequestCurrent(uint64_t chunkKey, uint64_t version);
+		bool waitForNearestKey(uint64_t& chunkKey, uint64_t& version, bool& useGreedyMeshing, uint32_t& lodLevel, uint8_t& sectionMask);
+	};
+}
+
+#endif
\ No newline at end of file
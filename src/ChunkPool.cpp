@@ -0,0 +1,193 @@
+#include "ChunkPool.h"
+#include "Chunk.h"
+#include <stdlib.h>
+#include <stdexcept>
+
+#ifdef _WIN32
+	#include <malloc.h>
+#elif defined(__linux__)
+	#include <sys/mman.h>
+#endif
+
+namespace yamc
+{
+	ChunkPool::ChunkPool() :
+		useHugePages(false),
+		slabOffset(SlabSize),
+		stats()
+	{
+	}
+
+	void ChunkPool::setHugePagesEnabled(bool isEnabled)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		useHugePages = isEnabled;
+	}
+
+	Chunk* ChunkPool::acquireChunk()
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			if (!freeChunks.empty()) {
+				Chunk* chunk = freeChunks.back();
+				freeChunks.pop_back();
+				stats.chunkHits++;
+				return chunk;
+			}
+			stats.chunkMisses++;
+		}
+
+		return new Chunk(this);
+	}
+
+	void ChunkPool::releaseChunk(Chunk* chunk)
+	{
+		chunk->clear();
+
+		std::lock_guard<std::mutex> guard(mutex);
+		freeChunks.push_back(chunk);
+	}
+
+	ChunkSection* ChunkPool::acquireSection()
+	{
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			if (!freeSections.empty()) {
+				ChunkSection* section = freeSections.back();
+				freeSections.pop_back();
+				stats.sectionHits++;
+				return section;
+			}
+			stats.sectionMisses++;
+		}
+
+		return new ChunkSection(this);
+	}
+
+	void ChunkPool::releaseSection(ChunkSection* section)
+	{
+		section->clear();
+
+		std::lock_guard<std::mutex> guard(mutex);
+		freeSections.push_back(section);
+	}
+
+	uint64_t* ChunkPool::allocateIndices(uint32_t bitsPerBlock)
+	{
+		uint32_t sizeClass = getSizeClass(bitsPerBlock);
+		size_t size = ChunkSection::BlockCount * bitsPerBlock / 8;
+
+		std::lock_guard<std::mutex> guard(mutex);
+		auto& freeList = freeIndicesBySizeClass[sizeClass];
+		if (!freeList.empty()) {
+			uint64_t* indices = freeList.back();
+			freeList.pop_back();
+			stats.indicesHits++;
+			return indices;
+		}
+		stats.indicesMisses++;
+
+		if (slabOffset + size > SlabSize) {
+			slabs.push_back(allocateSlab());
+			slabOffset = 0;
+			stats.slabCount = slabs.size();
+			stats.reservedBytes = slabs.size() * SlabSize;
+		}
+
+		uint64_t* indices = (uint64_t*)(slabs.back() + slabOffset);
+		slabOffset += size;
+		return indices;
+	}
+
+	void ChunkPool::freeIndices(uint64_t* indices, uint32_t bitsPerBlock)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		freeIndicesBySizeClass[getSizeClass(bitsPerBlock)].push_back(indices);
+	}
+
+	// Index slabs are bump-allocated and shared between sections, so only
+	// free Chunk and ChunkSection objects are returned to the heap here.
+	void ChunkPool::trim(size_t maxFreeChunks, size_t maxFreeSections)
+	{
+		std::vector<Chunk*> chunksToDelete;
+		std::vector<ChunkSection*> sectionsToDelete;
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			if (freeChunks.size() > maxFreeChunks) {
+				chunksToDelete.assign(freeChunks.begin() + maxFreeChunks, freeChunks.end());
+				freeChunks.resize(maxFreeChunks);
+			}
+			if (freeSections.size() > maxFreeSections) {
+				sectionsToDelete.assign(freeSections.begin() + maxFreeSections, freeSections.end());
+				freeSections.resize(maxFreeSections);
+			}
+		}
+
+		for (auto chunk : chunksToDelete) {
+			delete chunk;
+		}
+
+		for (auto section : sectionsToDelete) {
+			delete section;
+		}
+	}
+
+	ChunkPoolStats ChunkPool::getStats() const
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		return stats;
+	}
+
+	uint32_t ChunkPool::getSizeClass(uint32_t bitsPerBlock)
+	{
+		uint32_t sizeClass = 0;
+		while ((1u << sizeClass) < bitsPerBlock) {
+			sizeClass++;
+		}
+		return sizeClass;
+	}
+
+	uint8_t* ChunkPool::allocateSlab()
+	{
+#ifdef _WIN32
+		void* slab = _aligned_malloc(SlabSize, SlabSize);
+#else
+		void* slab = aligned_alloc(SlabSize, SlabSize);
+#endif
+		if (!slab) {
+			throw std::runtime_error("Cannot allocate chunk slab.");
+		}
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+		if (useHugePages) {
+			madvise(slab, SlabSize, MADV_HUGEPAGE);
+		}
+#endif
+
+		return (uint8_t*)slab;
+	}
+
+	void ChunkPool::freeSlab(uint8_t* slab)
+	{
+#ifdef _WIN32
+		_aligned_free(slab);
+#else
+		free(slab);
+#endif
+	}
+
+	ChunkPool::~ChunkPool()
+	{
+		for (auto chunk : freeChunks) {
+			delete chunk;
+		}
+
+		for (auto section : freeSections) {
+			delete section;
+		}
+
+		for (auto slab : slabs) {
+			freeSlab(slab);
+		}
+	}
+}
\ No newline at end of file
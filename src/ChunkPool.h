@@ -0,0 +1,66 @@
+#ifndef YAMC_CHUNK_POOL_H
+#define YAMC_CHUNK_POOL_H
+
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+
+namespace yamc
+{
+	class Chunk;
+	class ChunkSection;
+
+	struct ChunkPoolStats
+	{
+		uint64_t chunkHits;
+		uint64_t chunkMisses;
+		uint64_t sectionHits;
+		uint64_t sectionMisses;
+		uint64_t indicesHits;
+		uint64_t indicesMisses;
+		size_t slabCount;
+		size_t reservedBytes;
+	};
+
+	class ChunkPool
+	{
+	public:
+		static constexpr size_t SlabSize = 2 * 1024 * 1024;
+
+		ChunkPool();
+		ChunkPool(const ChunkPool&) = delete;
+		ChunkPool(ChunkPool&&) = delete;
+
+		void setHugePagesEnabled(bool isEnabled);
+
+		Chunk* acquireChunk();
+		void releaseChunk(Chunk* chunk);
+		ChunkSection* acquireSection();
+		void releaseSection(ChunkSection* section);
+		uint64_t* allocateIndices(uint32_t bitsPerBlock);
+		void freeIndices(uint64_t* indices, uint32_t bitsPerBlock);
+		void trim(size_t maxFreeChunks, size_t maxFreeSections);
+
+		ChunkPoolStats getStats() const;
+
+		~ChunkPool();
+
+	private:
+		static constexpr uint32_t SizeClassCount = 6;
+
+		mutable std::mutex mutex;
+		bool useHugePages;
+		std::vector<Chunk*> freeChunks;
+		std::vector<ChunkSection*> freeSections;
+		std::vector<uint64_t*> freeIndicesBySizeClass[SizeClassCount];
+		std::vector<uint8_t*> slabs;
+		size_t slabOffset;
+		ChunkPoolStats stats;
+
+		static uint32_t getSizeClass(uint32_t bitsPerBlock);
+		uint8_t* allocateSlab();
+		void freeSlab(uint8_t* slab);
+	};
+}
+
+#endif
\ No newline at end of file
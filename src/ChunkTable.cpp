@@ -0,0 +1,178 @@
+#include "ChunkTable.h"
+#include <atomic>
+
+namespace yamc
+{
+	static std::atomic<uint32_t> versionSeed(0);
+
+	ChunkTable::ChunkTable() :
+		slots(MinCapacity),
+		controls(MinCapacity, Empty),
+		fullCount(0),
+		deletedCount(0),
+		version(versionSeed.fetch_add(1 << 20))
+	{
+	}
+
+	ChunkTable::iterator ChunkTable::begin()
+	{
+		return iterator(this, 0);
+	}
+
+	ChunkTable::iterator ChunkTable::end()
+	{
+		return iterator(this, controls.size());
+	}
+
+	ChunkTable::const_iterator ChunkTable::begin() const
+	{
+		return const_iterator(this, 0);
+	}
+
+	ChunkTable::const_iterator ChunkTable::end() const
+	{
+		return const_iterator(this, controls.size());
+	}
+
+	size_t ChunkTable::hash(uint64_t key)
+	{
+		key *= 0x9E3779B97F4A7C15ull;
+		return (size_t)(key ^ (key >> 32));
+	}
+
+	size_t ChunkTable::findIndex(uint64_t key) const
+	{
+		size_t mask = controls.size() - 1;
+		for (size_t i = hash(key) & mask; ; i = (i + 1) & mask) {
+			uint8_t control = controls[i];
+			if (control == Empty) {
+				return controls.size();
+			}
+			if (control == Full && slots[i].first == key) {
+				return i;
+			}
+		}
+	}
+
+	ChunkTable::iterator ChunkTable::find(uint64_t key)
+	{
+		iterator it(this, controls.size());
+		it.index = findIndex(key);
+		return it;
+	}
+
+	ChunkTable::const_iterator ChunkTable::find(uint64_t key) const
+	{
+		const_iterator it(this, controls.size());
+		it.index = findIndex(key);
+		return it;
+	}
+
+	Chunk* ChunkTable::get(uint64_t key) const
+	{
+		size_t index = findIndex(key);
+		return index < controls.size() ? slots[index].second : nullptr;
+	}
+
+	size_t ChunkTable::count(uint64_t key) const
+	{
+		return findIndex(key) < controls.size() ? 1 : 0;
+	}
+
+	Chunk*& ChunkTable::operator[](uint64_t key)
+	{
+		size_t index = findIndex(key);
+		if (index < controls.size()) {
+			return slots[index].second;
+		}
+
+		if ((fullCount + deletedCount + 1) * 4 > controls.size() * 3) {
+			rehash(fullCount * 2 >= controls.size() ? controls.size() * 2 : controls.size());
+		}
+
+		size_t mask = controls.size() - 1;
+		size_t i = hash(key) & mask;
+		while (controls[i] == Full) {
+			i = (i + 1) & mask;
+		}
+
+		if (controls[i] == Deleted) {
+			deletedCount--;
+		}
+		controls[i] = Full;
+		slots[i] = value_type(key, nullptr);
+		fullCount++;
+
+		return slots[i].second;
+	}
+
+	ChunkTable::iterator ChunkTable::erase(iterator it)
+	{
+		controls[it.index] = Deleted;
+		slots[it.index].second = nullptr;
+		fullCount--;
+		deletedCount++;
+		version++;
+
+		return iterator(this, it.index + 1);
+	}
+
+	size_t ChunkTable::erase(uint64_t key)
+	{
+		auto it = find(key);
+		if (it == end()) {
+			return 0;
+		}
+
+		erase(it);
+		return 1;
+	}
+
+	void ChunkTable::clear()
+	{
+		slots.assign(MinCapacity, value_type(0, nullptr));
+		controls.assign(MinCapacity, Empty);
+		fullCount = 0;
+		deletedCount = 0;
+		version++;
+	}
+
+	size_t ChunkTable::size() const
+	{
+		return fullCount;
+	}
+
+	bool ChunkTable::empty() const
+	{
+		return fullCount == 0;
+	}
+
+	uint32_t ChunkTable::getVersion() const
+	{
+		return version;
+	}
+
+	void ChunkTable::rehash(size_t newCapacity)
+	{
+		std::vector<value_type> oldSlots(newCapacity);
+		std::vector<uint8_t> oldControls(newCapacity, Empty);
+		oldSlots.swap(slots);
+		oldControls.swap(controls);
+
+		size_t mask = newCapacity - 1;
+		for (size_t i = 0; i < oldControls.size(); i++) {
+			if (oldControls[i] != Full) {
+				continue;
+			}
+
+			size_t j = hash(oldSlots[i].first) & mask;
+			while (controls[j] == Full) {
+				j = (j + 1) & mask;
+			}
+			controls[j] = Full;
+			slots[j] = oldSlots[i];
+		}
+
+		deletedCount = 0;
+	}
+}
\ No newline at end of file
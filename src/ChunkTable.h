@@ -0,0 +1,118 @@
+#ifndef YAMC_CHUNK_TABLE_H
+#define YAMC_CHUNK_TABLE_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+namespace yamc
+{
+	class Chunk;
+
+	class ChunkTable
+	{
+	public:
+		using value_type = std::pair<uint64_t, Chunk*>;
+
+		template<typename Table, typename Value>
+		class Iterator
+		{
+		public:
+			Iterator(Table* table, size_t index) :
+				table(table),
+				index(index)
+			{
+				skipFreeSlots();
+			}
+
+			Value& operator*() const
+			{
+				return table->slots[index];
+			}
+
+			Value* operator->() const
+			{
+				return &table->slots[index];
+			}
+
+			Iterator& operator++()
+			{
+				index++;
+				skipFreeSlots();
+				return *this;
+			}
+
+			Iterator operator++(int)
+			{
+				Iterator previous = *this;
+				++(*this);
+				return previous;
+			}
+
+			bool operator==(const Iterator& other) const
+			{
+				return index == other.index;
+			}
+
+			bool operator!=(const Iterator& other) const
+			{
+				return index != other.index;
+			}
+
+		private:
+			friend class ChunkTable;
+
+			Table* table;
+			size_t index;
+
+			void skipFreeSlots()
+			{
+				while (index < table->controls.size() && table->controls[index] != Full) {
+					index++;
+				}
+			}
+		};
+
+		using iterator = Iterator<ChunkTable, value_type>;
+		using const_iterator = Iterator<const ChunkTable, const value_type>;
+
+		ChunkTable();
+
+		iterator begin();
+		iterator end();
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		iterator find(uint64_t key);
+		const_iterator find(uint64_t key) const;
+		Chunk* get(uint64_t key) const;
+		size_t count(uint64_t key) const;
+		Chunk*& operator[](uint64_t key);
+		iterator erase(iterator it);
+		size_t erase(uint64_t key);
+		void clear();
+
+		size_t size() const;
+		bool empty() const;
+		uint32_t getVersion() const;
+
+	private:
+		static constexpr uint8_t Empty = 0;
+		static constexpr uint8_t Full = 1;
+		static constexpr uint8_t Deleted = 2;
+		static constexpr size_t MinCapacity = 64;
+
+		std::vector<value_type> slots;
+		std::vector<uint8_t> controls;
+		size_t fullCount;
+		size_t deletedCount;
+		uint32_t version;
+
+		static size_t hash(uint64_t key);
+		size_t findIndex(uint64_t key) const;
+		void rehash(size_t newCapacity);
+	};
+}
+
+#endif
\ No newline at end of file
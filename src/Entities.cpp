@@ -101,8 +101,12 @@ namespace yamc
 
 			std::vector<glm::vec3> blockCollisionCandidates;
 			for (int x = imin.x; x <= imax.x; x++) {
-				for (int y = imin.y; y <= imax.y; y++) {
-					for (int z = imin.z; z <= imax.z; z++) {
+				for (int z = imin.z; z <= imax.z; z++) {
+					for (int y = imin.y; y <= imax.y; y++) {
+						if (terrain.isSectionEmpty(x, y, z)) {
+							y += Chunk::SectionHeight - 1 - getLocalBlockIndex(y, Chunk::SectionHeight);
+							continue;
+						}
 						if (terrain.getBlock(x, y, z) > 0) {
 							blockCollisionCandidates.push_back(glm::vec3(x, y, z));
 						}
@@ -135,6 +139,19 @@ namespace yamc
 		return false;
 	}
 
+	bool terrainSectionsAreEmptyAtY(const Terrain& terrain, const glm::ivec3& minBlockCoordinate, const glm::ivec3& maxBlockCoordinate, int y)
+	{
+		for (int x = minBlockCoordinate.x; x <= maxBlockCoordinate.x; x++) {
+			for (int z = minBlockCoordinate.z; z <= maxBlockCoordinate.z; z++) {
+				if (!terrain.isSectionEmpty(x, y, z)) {
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
 	void pushEntityToTheTop(const Terrain& terrain, Entity* entity)
 	{
 		auto minBoundary = entity->boundingBox.center - entity->boundingBox.halfSize;
@@ -143,6 +160,10 @@ namespace yamc
 		auto maxBlockCoordinate = glm::ivec3(glm::floor(maxBoundary));
 
 		for (int y = Chunk::MaxHeight - 1; y > 0; y--) {
+			if (terrainSectionsAreEmptyAtY(terrain, minBlockCoordinate, maxBlockCoordinate, y)) {
+				y -= y % Chunk::SectionHeight;
+				continue;
+			}
 			if (terrainContainsBlocksAtY(terrain, minBlockCoordinate, maxBlockCoordinate, y)) {
 				entity->boundingBox.center.y = y + 1 + entity->boundingBox.halfSize.y + 0.1f;
 				return;
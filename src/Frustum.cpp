@@ -0,0 +1,27 @@
+#include "Frustum.h"
+
+namespace yamc
+{
+	Frustum::Frustum(const glm::mat4& viewProjectionMatrix)
+	{
+		auto m = glm::transpose(viewProjectionMatrix);
+		planes[0] = m[3] + m[0];
+		planes[1] = m[3] - m[0];
+		planes[2] = m[3] + m[1];
+		planes[3] = m[3] - m[1];
+		planes[4] = m[3] + m[2];
+		planes[5] = m[3] - m[2];
+	}
+
+	bool Frustum::intersectsBox(const glm::vec3& min, const glm::vec3& max) const
+	{
+		for (int i = 0; i < PlaneCount; i++) {
+			const auto& plane = planes[i];
+			glm::vec3 farthestCorner(plane.x > 0 ? max.x : min.x, plane.y > 0 ? max.y : min.y, plane.z > 0 ? max.z : min.z);
+			if (glm::dot(glm::vec3(plane), farthestCorner) + plane.w < 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
\ No newline at end of file
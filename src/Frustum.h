@@ -0,0 +1,22 @@
+#ifndef YAMC_FRUSTUM_H
+#define YAMC_FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+namespace yamc
+{
+	class Frustum
+	{
+	public:
+		Frustum(const glm::mat4& viewProjectionMatrix);
+
+		bool intersectsBox(const glm::vec3& min, const glm::vec3& max) const;
+
+	private:
+		static constexpr int PlaneCount = 6;
+
+		glm::vec4 planes[PlaneCount];
+	};
+}
+
+#endif
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "Game.h"
 #include "Entities.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <limits>
 
 namespace yamc
 {
@@ -13,124 +17,390 @@ namespace yamc
 
 	Game::Game(uint32_t visibleChunksRadius) :
 		backgroundThread(),
-		isRunning(false)
+		backgroundTickMilliseconds(0.0f),
+		isRunning(false),
+		useGreedyMeshing(true),
+		meshingWorkerCount(1),
+		meshingPool(terrain, terrainMutex),
+		meshNeighborTimeoutMilliseconds(500.0f),
+		meshUploadBudgetBytes(2 * 1024 * 1024),
+		meshUploadBudgetMilliseconds(2.0f),
+		fullDetailChunkRadius(visibleChunksRadius),
+		lodCenterChunk(0, 0),
+		horizonChunkRadius(0),
+		generationWorkerCount(1),
+		viewDirection(0, 0, -1),
+		firstVisibleChunkMilliseconds(-1.0f),
+		lastPlayerPosition(0, 0, 0),
+		playerVelocity(0, 0, 0),
+		isPlayerPositionKnown(false),
+		prefetchTimer(0.0f),
+		prefetchChunkBudget(0),
+		prefetchedChunkCount(0),
+		isBackgroundUpdateRequested(false),
+		isSavingChunk(false),
+		savingChunkKey(0)
 	{
 		setVisibleChunkRadius(visibleChunksRadius);
+		meshingPool.setFullDetailRadius(fullDetailChunkRadius);
 	}
 
 	void Game::init()
 	{
 		isRunning = true;
+		loadingStartTime = std::chrono::steady_clock::now();
 		backgroundThread = std::move(std::thread(backgroundUpdateLoop, this));
+
+		for (uint32_t i = 0; i < generationWorkerCount; i++) {
+			generationWorkers.push_back(std::thread(generationWorkerLoop, this));
+		}
 	}
 
 	void Game::setVisibleChunkRadius(uint32_t visibleChunksRadius)
 	{
+		this->visibleChunksRadius = visibleChunksRadius;
 		minSurroundingChunksRadius = visibleChunksRadius + 1;
 		purgeRemainingChunksRadius = visibleChunksRadius + 2;
 		maxChunksInMemory = pow((purgeRemainingChunksRadius * 2 + 1), 2) * 3;
 	}
 
+	void Game::setViewDirection(const glm::vec3& viewDirection)
+	{
+		this->viewDirection = viewDirection;
+	}
+
 	void Game::unloadDistantChunks(const glm::vec3& position)
 	{
 		auto boundariesX = getMinMaxChunkOffsets(position.x, purgeRemainingChunksRadius, Chunk::MaxWidth);
 		auto boundariesZ = getMinMaxChunkOffsets(position.z, purgeRemainingChunksRadius, Chunk::MaxLength);
 
-		std::unordered_map<uint64_t, Chunk*>& chunks = terrain.getChunks();
+		std::lock_guard<std::mutex> guard(terrainMutex);
+		ChunkTable& chunks = terrain.getChunks();
 		std::set<uint64_t>& dirtyChunkKeys = terrain.getChunkKeysToSave();
 
 		for (auto it = chunks.begin(); it != chunks.end();) {
 			auto offset = getChunkOffset(it->first);
 			if (offset[0] < boundariesX[0] || offset[0] > boundariesX[1] ||
 				offset[1] < boundariesZ[0] || offset[1] > boundariesZ[1]) {
+				if (prefetchedChunkKeys.count(it->first) > 0) {
+					it++;
+					continue;
+				}
+
+				uint64_t chunkKey = it->first;
 				auto chunk = it->second;
-				if (dirtyChunkKeys.count(it->first) > 0) {
-					saveChunk(it->first, chunk);
-					dirtyChunkKeys.erase(it->first);
+				bool isDirty = dirtyChunkKeys.erase(chunkKey) > 0;
+
+				auto mesh = chunkMeshes.find(it->first);
+				if (mesh != chunkMeshes.end()) {
+					chunkBufferArena.release(mesh->second->allocation);
+					delete mesh->second;
+					chunkMeshes.erase(mesh);
 				}
 
-				chunkMeshes.erase(it->first);
+				meshingPool.cancel(it->first);
+				queuedMeshUploads.erase(it->first);
 				it = chunks.erase(it);
-				delete chunk;
+				if (isDirty) {
+					queueChunkSave(chunkKey, chunk);
+				}
+				else {
+					terrain.getChunkPool().releaseChunk(chunk);
+				}
 			}
 			else {
 				it++;
 			}
 		}
+
+		size_t maxFreeChunks = chunks.size() < maxChunksInMemory ? maxChunksInMemory - chunks.size() : 0;
+		terrain.getChunkPool().trim(maxFreeChunks, maxFreeChunks * Chunk::SectionCount);
 	}
 
 	void Game::update(const glm::vec3& playerPosition, float dt)
 	{
+		meshingPool.setFocus(playerPosition);
+
+		if (isPlayerPositionKnown && dt > 0.0f) {
+			glm::vec3 frameVelocity = (playerPosition - lastPlayerPosition) / dt;
+			playerVelocity += (frameVelocity - playerVelocity) * (std::min)(dt * VelocitySmoothing, 1.0f);
+		}
+		lastPlayerPosition = playerPosition;
+		isPlayerPositionKnown = true;
+
+		publishLoadedChunks();
 		requestSurroundingChunks(playerPosition);
+
+		prefetchTimer += dt;
+		if (prefetchTimer >= PrefetchIntervalSeconds) {
+			prefetchTimer = 0.0f;
+			prefetchChunksAhead(playerPosition);
+		}
+
 		if (terrain.getChunks().size() > maxChunksInMemory) {
 			unloadDistantChunks(playerPosition);
 		}
 	}
 
 	void Game::backgroundUpdate()
+	{
+	}
+
+	void Game::backgroundUpdateLoop(Game* game)
+	{
+		auto tickInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float, std::milli>(game->backgroundTickMilliseconds));
+		auto nextTick = std::chrono::steady_clock::now() + tickInterval;
+		auto hasWork = [game]() {
+			return !game->isRunning || game->isBackgroundUpdateRequested || !game->chunksToSave.empty();
+		};
+
+		std::unique_lock<std::mutex> lock(game->backgroundMutex);
+		while (true) {
+			if (game->backgroundTickMilliseconds > 0.0f) {
+				game->hasBackgroundWork.wait_until(lock, nextTick, hasWork);
+			}
+			else {
+				game->hasBackgroundWork.wait(lock, hasWork);
+			}
+
+			if (!game->chunksToSave.empty()) {
+				auto it = game->chunksToSave.begin();
+				uint64_t chunkKey = it->first;
+				Chunk* chunk = it->second;
+				game->chunksToSave.erase(it);
+				game->isSavingChunk = true;
+				game->savingChunkKey = chunkKey;
+				lock.unlock();
+
+				game->saveChunk(chunkKey, chunk);
+				game->terrain.getChunkPool().releaseChunk(chunk);
+
+				lock.lock();
+				game->isSavingChunk = false;
+				game->hasBackgroundWork.notify_all();
+				continue;
+			}
+
+			if (!game->isRunning) {
+				break;
+			}
+
+			bool isTickDue = game->backgroundTickMilliseconds > 0.0f && std::chrono::steady_clock::now() >= nextTick;
+			if (game->isBackgroundUpdateRequested || isTickDue) {
+				game->isBackgroundUpdateRequested = false;
+				lock.unlock();
+				game->backgroundUpdate();
+				lock.lock();
+				nextTick = std::chrono::steady_clock::now() + tickInterval;
+			}
+		}
+	}
+
+	void Game::generationWorkerLoop(Game* game)
 	{
 		uint64_t chunkKey = 0;
-		{
-			std::lock_guard<std::mutex> guard(chunksToLoadMutex);
-			if (chunkKeysToLoad.empty()) {
-				return;
+		while (game->generationQueue.waitForNearestKey(chunkKey)) {
+			bool isDirty = false;
+			Chunk* chunk = game->acquireChunk(chunkKey, isDirty);
+			if (chunk == nullptr) {
+				game->generationQueue.finish(chunkKey);
+				continue;
 			}
 
-			chunkKey = chunkKeysToLoad.front();
-			chunkKeysToLoad.pop();
+			std::lock_guard<std::mutex> guard(game->loadedChunksMutex);
+			game->loadedChunks.push_back({ chunkKey, chunk, isDirty });
+		}
+	}
+
+	void Game::publishLoadedChunks()
+	{
+		{
+			std::lock_guard<std::mutex> guard(loadedChunksMutex);
+			loadedChunksToPublish.swap(loadedChunks);
+		}
+
+		for (auto& loadedChunk : loadedChunksToPublish) {
+			publishChunk(loadedChunk.chunkKey, loadedChunk.chunk, loadedChunk.isDirty);
+			generationQueue.finish(loadedChunk.chunkKey);
+		}
+		loadedChunksToPublish.clear();
+	}
+
+	Chunk* Game::acquireChunk(uint64_t chunkKey, bool& isDirty)
+	{
+		{
+			std::unique_lock<std::mutex> lock(backgroundMutex);
+			hasBackgroundWork.wait(lock, [this, chunkKey]() { return !isSavingChunk || savingChunkKey != chunkKey; });
+
+			auto it = chunksToSave.find(chunkKey);
+			if (it != chunksToSave.end()) {
+				Chunk* chunk = it->second;
+				chunksToSave.erase(it);
+				isDirty = true;
+				return chunk;
+			}
 		}
-		
-		std::lock_guard<std::mutex> guard(terrainMutex);
-		std::unordered_map<uint64_t, Chunk*>& chunks = terrain.getChunks();
 
-		auto chunk = loadChunk(chunkKey);
-		if (chunk == nullptr) {
+		isDirty = false;
+		return loadChunk(chunkKey);
+	}
+
+	void Game::publishChunk(uint64_t chunkKey, Chunk* chunk, bool isDirty)
+	{
+		std::lock_guard<std::mutex> guard(terrainMutex);
+		ChunkTable& chunks = terrain.getChunks();
+		bool isInBounds = generationQueue.isInBounds(chunkKey);
+		if (chunks.find(chunkKey) != chunks.end() || (!isInBounds && !generationQueue.isPrefetchKey(chunkKey))) {
+			if (isDirty) {
+				queueChunkSave(chunkKey, chunk);
+			}
+			else {
+				terrain.getChunkPool().releaseChunk(chunk);
+			}
 			return;
 		}
 
 		chunks[chunkKey] = chunk;
+		if (!isInBounds) {
+			prefetchedChunkKeys.insert(chunkKey);
+		}
+		if (isDirty) {
+			terrain.getChunkKeysToSave().insert(chunkKey);
+		}
 		terrain.addToRebuildWithAdjacent(chunkKey);
 	}
 
-	void Game::backgroundUpdateLoop(Game* game)
+	void Game::queueChunkSave(uint64_t chunkKey, Chunk* chunk)
 	{
-		while (game->isRunning) {
-			game->backgroundUpdate();
-		}
+		std::lock_guard<std::mutex> guard(backgroundMutex);
+		chunksToSave[chunkKey] = chunk;
+		hasBackgroundWork.notify_all();
+	}
+
+	void Game::notifyBackgroundWork()
+	{
+		std::lock_guard<std::mutex> guard(backgroundMutex);
+		isBackgroundUpdateRequested = true;
+		hasBackgroundWork.notify_all();
 	}
 
 	void Game::requestSurroundingChunks(const glm::vec3& playerPosition)
 	{
-		std::unordered_map<uint64_t, Chunk*>& chunks = terrain.getChunks();
+		ChunkTable& chunks = terrain.getChunks();
 
 		auto boundariesX = getMinMaxChunkOffsets(playerPosition.x, minSurroundingChunksRadius, Chunk::MaxWidth);
 		auto boundariesZ = getMinMaxChunkOffsets(playerPosition.z, minSurroundingChunksRadius, Chunk::MaxLength);
+		generationQueue.setFocus(playerPosition, viewDirection);
+		generationQueue.setBounds(glm::ivec2(boundariesX[0], boundariesZ[0]), glm::ivec2(boundariesX[1], boundariesZ[1]));
 
-		for (int x = boundariesX[0]; x <= boundariesX[1]; x++) {
-			for (int z = boundariesZ[0]; z <= boundariesZ[1]; z++) {
-				auto key = getChunkKey(x, z);
-				if (chunks.find(key) == chunks.end()) {
-					std::lock_guard<std::mutex> guard(chunksToLoadMutex);
-					chunkKeysToLoad.push(key);
+		missingChunkKeys.clear();
+		{
+			std::lock_guard<std::mutex> guard(terrainMutex);
+			for (int x = boundariesX[0]; x <= boundariesX[1]; x++) {
+				for (int z = boundariesZ[0]; z <= boundariesZ[1]; z++) {
+					auto key = getChunkKey(x, z);
+					if (chunks.find(key) == chunks.end()) {
+						missingChunkKeys.push_back(key);
+					}
 				}
 			}
 		}
+
+		generationQueue.request(missingChunkKeys);
+	}
+
+	void Game::prefetchChunksAhead(const glm::vec3& playerPosition)
+	{
+		glm::vec2 position(playerPosition.x, playerPosition.z);
+		glm::vec2 velocity(playerVelocity.x, playerVelocity.z);
+		float speed = glm::length(velocity);
+
+		auto loadBoundariesX = getMinMaxChunkOffsets(playerPosition.x, minSurroundingChunksRadius, Chunk::MaxWidth);
+		auto loadBoundariesZ = getMinMaxChunkOffsets(playerPosition.z, minSurroundingChunksRadius, Chunk::MaxLength);
+
+		prefetchRegionKeys.clear();
+		prefetchCandidates.clear();
+		prefetchKeys.clear();
+
+		std::lock_guard<std::mutex> guard(terrainMutex);
+		ChunkTable& chunks = terrain.getChunks();
+
+		if (speed >= MinPrefetchSpeed && prefetchChunkBudget > 0) {
+			glm::vec2 direction = velocity / speed;
+			glm::vec2 lookDirection(viewDirection.x, viewDirection.z);
+			glm::vec2 axis = direction * 2.0f + (glm::length(lookDirection) > 0.0001f ? glm::normalize(lookDirection) : glm::vec2(0, 0));
+			axis = glm::length(axis) > 0.0001f ? glm::normalize(axis) : direction;
+
+			float lookahead = (std::min)(speed * PrefetchLookaheadSeconds, (float)(MaxPrefetchChunkDistance * Chunk::MaxWidth));
+			float reach = (minSurroundingChunksRadius + 0.5f) * Chunk::MaxWidth + lookahead;
+			uint32_t prefetchRadius = minSurroundingChunksRadius + (uint32_t)ceilf(lookahead / Chunk::MaxWidth);
+			auto boundariesX = getMinMaxChunkOffsets(playerPosition.x, prefetchRadius, Chunk::MaxWidth);
+			auto boundariesZ = getMinMaxChunkOffsets(playerPosition.z, prefetchRadius, Chunk::MaxLength);
+
+			for (int x = boundariesX[0]; x <= boundariesX[1]; x++) {
+				for (int z = boundariesZ[0]; z <= boundariesZ[1]; z++) {
+					if (x >= loadBoundariesX[0] && x <= loadBoundariesX[1] && z >= loadBoundariesZ[0] && z <= loadBoundariesZ[1]) {
+						continue;
+					}
+
+					glm::vec2 delta = glm::vec2((x + 0.5f) * Chunk::MaxWidth, (z + 0.5f) * Chunk::MaxLength) - position;
+					float distance = glm::length(delta);
+					if (distance > reach || glm::dot(delta / distance, axis) < PrefetchConeCosine) {
+						continue;
+					}
+
+					auto key = getChunkKey(x, z);
+					prefetchRegionKeys.insert(key);
+					if (chunks.find(key) == chunks.end()) {
+						prefetchCandidates.push_back(std::make_pair(distance, key));
+					}
+				}
+			}
+		}
+
+		for (auto it = prefetchedChunkKeys.begin(); it != prefetchedChunkKeys.end();) {
+			if (prefetchRegionKeys.count(*it) == 0 || chunks.find(*it) == chunks.end()) {
+				it = prefetchedChunkKeys.erase(it);
+			}
+			else {
+				it++;
+			}
+		}
+		prefetchedChunkCount = prefetchedChunkKeys.size();
+
+		std::sort(prefetchCandidates.begin(), prefetchCandidates.end());
+		size_t budget = prefetchChunkBudget > prefetchedChunkCount ? prefetchChunkBudget - prefetchedChunkCount : 0;
+		for (size_t i = 0; i < prefetchCandidates.size() && i < budget; i++) {
+			prefetchKeys.push_back(prefetchCandidates[i].second);
+		}
+
+		generationQueue.setPrefetchKeys(prefetchKeys);
 	}
 
 	void Game::loadSurroundingChunks(const glm::vec3& playerPosition)
 	{
-		std::unordered_map<uint64_t, Chunk*>& chunks = terrain.getChunks();
+		ChunkTable& chunks = terrain.getChunks();
 
 		auto boundariesX = getMinMaxChunkOffsets(playerPosition.x, minSurroundingChunksRadius, Chunk::MaxWidth);
 		auto boundariesZ = getMinMaxChunkOffsets(playerPosition.z, minSurroundingChunksRadius, Chunk::MaxLength);
+		generationQueue.setFocus(playerPosition, viewDirection);
+		generationQueue.setBounds(glm::ivec2(boundariesX[0], boundariesZ[0]), glm::ivec2(boundariesX[1], boundariesZ[1]));
 
 		for (int x = boundariesX[0]; x <= boundariesX[1]; x++) {
 			for (int z = boundariesZ[0]; z <= boundariesZ[1]; z++) {
 				auto key = getChunkKey(x, z);
-				if (chunks.find(key) == chunks.end()) {
-					auto chunk = loadChunk(key);
-					terrain.addToRebuildWithAdjacent(key);
-					chunks[key] = chunk;
+				bool isLoaded = false;
+				{
+					std::lock_guard<std::mutex> guard(terrainMutex);
+					isLoaded = chunks.find(key) != chunks.end();
+				}
+
+				if (!isLoaded) {
+					bool isDirty = false;
+					auto chunk = acquireChunk(key, isDirty);
+					if (chunk != nullptr) {
+						publishChunk(key, chunk, isDirty);
+					}
 				}
 			}
 		}
@@ -146,35 +416,326 @@ namespace yamc
 		return terrain;
 	}
 
-	const std::unordered_map<uint64_t, Mesh*>& Game::getChunkMeshes() const
+	const std::unordered_map<uint64_t, ChunkMesh*>& Game::getChunkMeshes() const
 	{
 		return chunkMeshes;
 	}
 
-	void Game::rebuildChunkMeshes(Renderer* renderer)
+	const ChunkBufferArena& Game::getChunkBufferArena() const
 	{
-		std::lock_guard<std::mutex> guard(terrainMutex);
-		auto& chunksToRebuild = terrain.getChunkKeysToRebuild();
-		for (uint64_t chunkKey : chunksToRebuild) {
-			auto chunk = terrain.getChunks()[chunkKey];
-			auto meshEntry = chunkMeshes.find(chunkKey);
-			Mesh* chunkMesh = nullptr;
+		return chunkBufferArena;
+	}
+
+	void Game::rebuildChunkMeshes(Renderer* renderer, const Frustum& frustum, const glm::vec3& cameraPosition)
+	{
+		if (!meshingPool.isRunning()) {
+			meshingPool.start(&renderer->getMeshBuilder(), meshingWorkerCount);
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(terrainMutex);
+			auto now = std::chrono::steady_clock::now();
+			auto& chunksToRebuild = terrain.getChunkKeysToRebuild();
+			for (uint64_t chunkKey : chunksToRebuild) {
+				deferredMeshKeys.emplace(chunkKey, now);
+			}
 
-			if (meshEntry == chunkMeshes.end()) {
-				chunkMesh = new Mesh();
-				chunkMeshes[chunkKey] = chunkMesh;
+			for (auto it = deferredMeshKeys.begin(); it != deferredMeshKeys.end();) {
+				float waitedMilliseconds = std::chrono::duration<float, std::milli>(now - it->second).count();
+				if (terrain.getChunks().count(it->first) == 0) {
+					it = deferredMeshKeys.erase(it);
+				}
+				else if (terrain.areNeighborsLoaded(it->first) || waitedMilliseconds >= meshNeighborTimeoutMilliseconds) {
+					meshingPool.request(it->first);
+					it = deferredMeshKeys.erase(it);
+				}
+				else {
+					it++;
+				}
+			}
+
+			auto& sectionsToRebuild = terrain.getSectionsToRebuild();
+			for (auto& pair : sectionsToRebuild) {
+				if (deferredMeshKeys.count(pair.first) > 0) {
+					continue;
+				}
+
+				auto mesh = chunkMeshes.find(pair.first);
+				if (mesh == chunkMeshes.end() || mesh->second->lodLevel != 0) {
+					meshingPool.request(pair.first);
+				}
+				else {
+					meshingPool.requestSections(pair.first, pair.second);
+				}
+			}
+
+			chunksToRebuild.clear();
+			sectionsToRebuild.clear();
+		}
+
+		glm::ivec2 cameraChunk(getChunkIndex((int)floorf(cameraPosition.x), Chunk::MaxWidth), getChunkIndex((int)floorf(cameraPosition.z), Chunk::MaxLength));
+		if (cameraChunk != lodCenterChunk) {
+			lodCenterChunk = cameraChunk;
+			for (auto& pair : chunkMeshes) {
+				auto offset = getChunkOffset(pair.first);
+				int chunkDistance = (std::max)(abs(offset[0] - cameraChunk.x), abs(offset[1] - cameraChunk.y));
+				if (MeshBuilder::getLodLevel(chunkDistance, fullDetailChunkRadius) != pair.second->lodLevel) {
+					meshingPool.request(pair.first);
+				}
+			}
+		}
+		updateHorizon(cameraChunk);
+
+		meshingPool.takeResults(meshResults);
+		for (auto& result : meshResults) {
+			if (result.meshData.sectionMask == Chunk::AllSectionsMask) {
+				queuedMeshUploads[result.chunkKey] = std::move(result);
+				continue;
+			}
+
+			auto queuedUpload = queuedMeshUploads.find(result.chunkKey);
+			if (queuedUpload != queuedMeshUploads.end()) {
+				uploadChunkMesh(queuedUpload->second);
+				queuedMeshUploads.erase(queuedUpload);
+			}
+			uploadChunkMesh(result);
+		}
+
+		meshUploadOrder.clear();
+		for (auto& pair : queuedMeshUploads) {
+			auto offset = getChunkOffset(pair.first);
+			glm::vec3 min(offset[0] * (float)Chunk::MaxWidth, 0, offset[1] * (float)Chunk::MaxLength);
+			glm::vec3 max = min + glm::vec3(Chunk::MaxWidth, Chunk::MaxHeight, Chunk::MaxLength);
+			glm::vec2 delta = glm::vec2(min.x + Chunk::MaxWidth / 2, min.z + Chunk::MaxLength / 2) - glm::vec2(cameraPosition.x, cameraPosition.z);
+
+			MeshUpload upload;
+			upload.isVisible = frustum.intersectsBox(min, max);
+			upload.distance = glm::dot(delta, delta);
+			upload.chunkKey = pair.first;
+			meshUploadOrder.push_back(upload);
+		}
+
+		std::sort(meshUploadOrder.begin(), meshUploadOrder.end(), [](const MeshUpload& a, const MeshUpload& b) {
+			if (a.isVisible != b.isVisible) {
+				return a.isVisible;
+			}
+			return a.distance < b.distance;
+		});
+
+		auto startTime = std::chrono::steady_clock::now();
+		size_t uploadedBytes = 0;
+		for (auto& upload : meshUploadOrder) {
+			float elapsedMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+			if (uploadedBytes > 0 && (uploadedBytes >= meshUploadBudgetBytes || elapsedMilliseconds >= meshUploadBudgetMilliseconds)) {
+				break;
+			}
+
+			if (upload.isVisible && firstVisibleChunkMilliseconds < 0.0f) {
+				firstVisibleChunkMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - loadingStartTime).count();
+			}
+
+			auto result = queuedMeshUploads.find(upload.chunkKey);
+			uploadChunkMesh(result->second);
+			uploadedBytes += result->second.meshData.vertices.size() * sizeof(glm::uvec2) + result->second.meshData.indices.size() * sizeof(uint32_t);
+			queuedMeshUploads.erase(result);
+		}
+	}
+
+	void Game::uploadChunkMesh(ChunkMeshResult& result)
+	{
+		auto meshEntry = chunkMeshes.find(result.chunkKey);
+		ChunkMesh* chunkMesh = nullptr;
+
+		if (result.meshData.sectionMask != Chunk::AllSectionsMask) {
+			if (meshEntry == chunkMeshes.end() || meshEntry->second->lodLevel != result.meshData.lodLevel) {
+				meshingPool.request(result.chunkKey);
 			}
 			else {
-				chunkMesh = chunkMeshes[chunkKey];
+				patchChunkMesh(meshEntry->second, result);
 			}
+			return;
+		}
 
-			renderer->getMeshBuilder().rebuildChunk(chunkKey, chunk, &terrain, chunkMesh);
+		if (meshEntry == chunkMeshes.end()) {
+			chunkMesh = new ChunkMesh();
+			chunkMeshes[result.chunkKey] = chunkMesh;
+		}
+		else {
+			chunkMesh = meshEntry->second;
 		}
-		chunksToRebuild.clear();
+
+		auto offset = getChunkOffset(result.chunkKey);
+		chunkBufferArena.upload(chunkMesh->allocation, offset[0], offset[1], result.meshData.vertices, result.meshData.indices);
+		std::copy(std::begin(result.meshData.sections), std::end(result.meshData.sections), chunkMesh->sections);
+		std::copy(std::begin(result.meshData.sectionConnectivity), std::end(result.meshData.sectionConnectivity), chunkMesh->sectionConnectivity);
+		chunkMesh->lodLevel = result.meshData.lodLevel;
+	}
+
+	void Game::patchChunkMesh(ChunkMesh* chunkMesh, ChunkMeshResult& result)
+	{
+		const ChunkMeshData& meshData = result.meshData;
+
+		meshPatchSpans.clear();
+		uint32_t indexCount = 0;
+		for (uint32_t i = 0; i < Chunk::SectionCount; i++) {
+			bool isRebuilt = (meshData.sectionMask & (1 << i)) != 0;
+			const IndexRange& source = isRebuilt ? meshData.sections[i] : chunkMesh->sections[i];
+
+			ChunkVertexSpan span;
+			span.offset = source.offset / 6 * 4;
+			span.count = source.count / 6 * 4;
+			span.isUploaded = isRebuilt;
+			meshPatchSpans.push_back(span);
+
+			chunkMesh->sections[i].offset = indexCount;
+			chunkMesh->sections[i].count = source.count;
+			indexCount += source.count;
+
+			if (isRebuilt) {
+				chunkMesh->sectionConnectivity[i] = meshData.sectionConnectivity[i];
+			}
+		}
+
+		MeshBuilder::buildQuadIndices(indexCount / 6 * 4, meshPatchIndices);
+		chunkBufferArena.patch(chunkMesh->allocation, meshPatchSpans, result.meshData.vertices, meshPatchIndices);
+	}
+
+	void Game::updateHorizon(const glm::ivec2& cameraChunk)
+	{
+		if (horizonChunkRadius <= (int)visibleChunksRadius) {
+			if (horizonMesh.getIndicesCount() > 0) {
+				horizonIndices.clear();
+				horizonMesh.setData(horizonPositions, horizonShading, horizonIndices);
+			}
+			return;
+		}
+
+		if (horizonMap.update(cameraChunk, visibleChunksRadius, horizonChunkRadius, getSeed())) {
+			horizonMap.buildMesh(horizonPositions, horizonShading, horizonIndices);
+			horizonMesh.setData(horizonPositions, horizonShading, horizonIndices);
+		}
+	}
+
+	const Mesh& Game::getHorizonMesh() const
+	{
+		return horizonMesh;
+	}
+
+	uint32_t Game::getHorizonSampleCount() const
+	{
+		return horizonMap.getSampledHeightCount();
+	}
+
+	uint64_t Game::getTerrainTriangleCount() const
+	{
+		uint64_t triangleCount = 0;
+		for (auto& pair : chunkMeshes) {
+			triangleCount += pair.second->allocation.indexCount / 3;
+		}
+		return triangleCount;
+	}
+
+	void Game::setGreedyMeshingEnabled(bool isEnabled)
+	{
+		if (useGreedyMeshing == isEnabled) {
+			return;
+		}
+
+		useGreedyMeshing = isEnabled;
+		meshingPool.setGreedyMeshingEnabled(isEnabled);
+
+		std::lock_guard<std::mutex> guard(terrainMutex);
+		for (auto& pair : terrain.getChunks()) {
+			terrain.getChunkKeysToRebuild().insert(pair.first);
+		}
+	}
+
+	bool Game::isGreedyMeshingEnabled() const
+	{
+		return useGreedyMeshing;
+	}
+
+	void Game::setMeshingWorkerCount(uint32_t workerCount)
+	{
+		meshingWorkerCount = workerCount;
+	}
+
+	void Game::setMeshUploadBudget(size_t bytes, float milliseconds)
+	{
+		meshUploadBudgetBytes = bytes;
+		meshUploadBudgetMilliseconds = milliseconds;
+	}
+
+	void Game::setFullDetailChunkRadius(int radius)
+	{
+		fullDetailChunkRadius = radius;
+		meshingPool.setFullDetailRadius(radius);
+		lodCenterChunk = glm::ivec2((std::numeric_limits<int>::max)());
+	}
+
+	void Game::setGenerationWorkerCount(uint32_t workerCount)
+	{
+		generationWorkerCount = (std::max)(workerCount, 1u);
+	}
+
+	size_t Game::getPendingGenerationCount() const
+	{
+		return generationQueue.getPendingCount();
+	}
+
+	ChunkGenerationQueueStats Game::getGenerationStats() const
+	{
+		return generationQueue.getStats();
+	}
+
+	float Game::getFirstVisibleChunkTime() const
+	{
+		return firstVisibleChunkMilliseconds;
+	}
+
+	size_t Game::getPrefetchedChunkCount() const
+	{
+		return prefetchedChunkCount;
+	}
+
+	void Game::setMeshNeighborTimeout(float milliseconds)
+	{
+		meshNeighborTimeoutMilliseconds = milliseconds;
+	}
+
+	void Game::setHorizonChunkRadius(int radius)
+	{
+		horizonChunkRadius = radius;
+	}
+
+	void Game::setPrefetchChunkBudget(uint32_t chunkCount)
+	{
+		prefetchChunkBudget = chunkCount;
+	}
+
+	size_t Game::getQueuedMeshUploadCount() const
+	{
+		return queuedMeshUploads.size();
+	}
+
+	size_t Game::getPendingMeshingCount() const
+	{
+		return meshingPool.getPendingCount();
+	}
+
+	size_t Game::getDeferredMeshingCount() const
+	{
+		return deferredMeshKeys.size();
+	}
+
+	ChunkMeshingPoolStats Game::getMeshingStats() const
+	{
+		return meshingPool.getStats();
 	}
 
 	void Game::setBlock(int x, int y, int z, uint32_t type)
 	{
+		std::lock_guard<std::mutex> guard(terrainMutex);
 		terrain.setBlock(x, y, z, type);
 	}
 
@@ -185,10 +746,33 @@ namespace yamc
 
 	void Game::destroy()
 	{
-		isRunning = false;
+		meshingPool.stop();
+
+		generationQueue.stop();
+		for (auto& worker : generationWorkers) {
+			worker.join();
+		}
+		generationWorkers.clear();
+
+		for (auto& loadedChunk : loadedChunks) {
+			if (loadedChunk.isDirty) {
+				queueChunkSave(loadedChunk.chunkKey, loadedChunk.chunk);
+			}
+			else {
+				terrain.getChunkPool().releaseChunk(loadedChunk.chunk);
+			}
+		}
+		loadedChunks.clear();
+
+		{
+			std::lock_guard<std::mutex> guard(backgroundMutex);
+			isRunning = false;
+			hasBackgroundWork.notify_all();
+		}
 		backgroundThread.join();
 
 		for (auto pair : chunkMeshes) {
+			chunkBufferArena.release(pair.second->allocation);
 			delete pair.second;
 		}
 	}
@@ -5,33 +5,73 @@
 #include "Entities.h"
 #include "WorldDataManager.h"
 #include "Renderer.h"
-#include <queue>
+#include "ChunkMeshingPool.h"
+#include "Frustum.h"
+#include "HorizonMap.h"
+#include "ChunkGenerationQueue.h"
+#include <chrono>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace yamc
 {
 	class Game
 	{
+	private:
+		static constexpr float PrefetchIntervalSeconds = 0.25f;
+		static constexpr float PrefetchLookaheadSeconds = 3.0f;
+		static constexpr float PrefetchConeCosine = 0.85f;
+		static constexpr float MinPrefetchSpeed = 1.0f;
+		static constexpr float VelocitySmoothing = 4.0f;
+		static constexpr int MaxPrefetchChunkDistance = 8;
+
 	public:
 		Game(uint32_t visibleChunksRadius);
 
 		virtual void init();
 
 		void setVisibleChunkRadius(uint32_t visibleChunksRadius);
+		void setViewDirection(const glm::vec3& viewDirection);
 		virtual void update(const glm::vec3& playerPosition, float dt);
 		static void backgroundUpdateLoop(Game* game);
+		static void generationWorkerLoop(Game* game);
 
 		virtual void loadSurroundingChunks(const glm::vec3& playerPosition);
 
 		const Terrain& getTerrain() const;
 		Terrain& getTerrain();
 
-		const std::unordered_map<uint64_t, Mesh*>& getChunkMeshes() const;
-		void rebuildChunkMeshes(Renderer* renderer);
+		const std::unordered_map<uint64_t, ChunkMesh*>& getChunkMeshes() const;
+		const ChunkBufferArena& getChunkBufferArena() const;
+		void rebuildChunkMeshes(Renderer* renderer, const Frustum& frustum, const glm::vec3& cameraPosition);
+		uint64_t getTerrainTriangleCount() const;
+
+		void setGreedyMeshingEnabled(bool isEnabled);
+		bool isGreedyMeshingEnabled() const;
+		void setMeshingWorkerCount(uint32_t workerCount);
+		void setGenerationWorkerCount(uint32_t workerCount);
+		void setMeshUploadBudget(size_t bytes, float milliseconds);
+		void setFullDetailChunkRadius(int radius);
+		void setMeshNeighborTimeout(float milliseconds);
+		void setHorizonChunkRadius(int radius);
+		void setPrefetchChunkBudget(uint32_t chunkCount);
+		const Mesh& getHorizonMesh() const;
+		uint32_t getHorizonSampleCount() const;
+		size_t getQueuedMeshUploadCount() const;
+		size_t getPendingMeshingCount() const;
+		size_t getPendingGenerationCount() const;
+		ChunkGenerationQueueStats getGenerationStats() const;
+		float getFirstVisibleChunkTime() const;
+		size_t getPrefetchedChunkCount() const;
+		size_t getDeferredMeshingCount() const;
+		ChunkMeshingPoolStats getMeshingStats() const;
 
 		virtual void setBlock(int x, int y, int z, uint32_t type);
 		virtual uint32_t getBlock(int x, int y, int z) const;
+		virtual int getSeed() const = 0;
 
 		virtual void destroy();
 
@@ -42,19 +82,90 @@ namespace yamc
 		uint32_t maxChunksInMemory;
 		std::thread backgroundThread;
 		std::mutex terrainMutex;
+		float backgroundTickMilliseconds;
 
 		void requestSurroundingChunks(const glm::vec3& playerPosition);
+		void prefetchChunksAhead(const glm::vec3& playerPosition);
+		void publishChunk(uint64_t chunkKey, Chunk* chunk, bool isDirty);
 		void unloadDistantChunks(const glm::vec3& position);
+		void queueChunkSave(uint64_t chunkKey, Chunk* chunk);
+		void notifyBackgroundWork();
 
 		virtual Chunk* loadChunk(uint64_t key) = 0;
 		virtual void saveChunk(uint64_t key, Chunk* chunk) = 0;
 		virtual void backgroundUpdate();
 
 	private:
+		struct MeshUpload
+		{
+			bool isVisible;
+			float distance;
+			uint64_t chunkKey;
+		};
+
+		struct LoadedChunk
+		{
+			uint64_t chunkKey;
+			Chunk* chunk;
+			bool isDirty;
+		};
+
+		void uploadChunkMesh(ChunkMeshResult& result);
+		void updateHorizon(const glm::ivec2& cameraChunk);
+		void patchChunkMesh(ChunkMesh* chunkMesh, ChunkMeshResult& result);
+		void publishLoadedChunks();
+		Chunk* acquireChunk(uint64_t chunkKey, bool& isDirty);
+
 		bool isRunning;
-		std::unordered_map<uint64_t, Mesh*> chunkMeshes;
-		std::queue<uint64_t> chunkKeysToLoad;
-		std::mutex chunksToLoadMutex;
+		bool useGreedyMeshing;
+		uint32_t meshingWorkerCount;
+		ChunkMeshingPool meshingPool;
+		std::unordered_map<uint64_t, ChunkMesh*> chunkMeshes;
+		ChunkBufferArena chunkBufferArena;
+		std::vector<ChunkMeshResult> meshResults;
+		std::unordered_map<uint64_t, ChunkMeshResult> queuedMeshUploads;
+		std::unordered_map<uint64_t, std::chrono::steady_clock::time_point> deferredMeshKeys;
+		float meshNeighborTimeoutMilliseconds;
+		std::vector<MeshUpload> meshUploadOrder;
+		size_t meshUploadBudgetBytes;
+		float meshUploadBudgetMilliseconds;
+		int fullDetailChunkRadius;
+		glm::ivec2 lodCenterChunk;
+		uint32_t visibleChunksRadius;
+		int horizonChunkRadius;
+		HorizonMap horizonMap;
+		Mesh horizonMesh;
+		std::vector<glm::vec3> horizonPositions;
+		std::vector<glm::vec2> horizonShading;
+		std::vector<uint32_t> horizonIndices;
+		std::vector<ChunkVertexSpan> meshPatchSpans;
+		std::vector<uint32_t> meshPatchIndices;
+		uint32_t generationWorkerCount;
+		ChunkGenerationQueue generationQueue;
+		std::vector<std::thread> generationWorkers;
+		std::mutex loadedChunksMutex;
+		std::vector<LoadedChunk> loadedChunks;
+		std::vector<LoadedChunk> loadedChunksToPublish;
+		std::vector<uint64_t> missingChunkKeys;
+		glm::vec3 viewDirection;
+		std::chrono::steady_clock::time_point loadingStartTime;
+		float firstVisibleChunkMilliseconds;
+		glm::vec3 lastPlayerPosition;
+		glm::vec3 playerVelocity;
+		bool isPlayerPositionKnown;
+		float prefetchTimer;
+		uint32_t prefetchChunkBudget;
+		size_t prefetchedChunkCount;
+		std::unordered_set<uint64_t> prefetchedChunkKeys;
+		std::unordered_set<uint64_t> prefetchRegionKeys;
+		std::vector<std::pair<float, uint64_t>> prefetchCandidates;
+		std::vector<uint64_t> prefetchKeys;
+		std::mutex backgroundMutex;
+		std::condition_variable hasBackgroundWork;
+		bool isBackgroundUpdateRequested;
+		bool isSavingChunk;
+		uint64_t savingChunkKey;
+		std::unordered_map<uint64_t, Chunk*> chunksToSave;
 	};
 }
 
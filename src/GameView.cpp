@@ -55,6 +55,7 @@ namespace yamc
 			player.velocity.y -= Gravity * dt;
 		}
 
+		game->setViewDirection(camera.getLookDirection());
 		game->update(player.boundingBox.center, dt);
 		updateEntityPosition(game->getTerrain(), &player, dt);
 
@@ -176,6 +177,13 @@ namespace yamc
 		}
 	}
 
+	void GameView::onKeyPress(int key, int)
+	{
+		if (key == GLFW_KEY_G) {
+			game->setGreedyMeshingEnabled(!game->isGreedyMeshingEnabled());
+		}
+	}
+
 	void GameView::updateMoveKeys(float dt)
 	{
 		float speedForward = 0;
@@ -219,19 +227,23 @@ namespace yamc
 
 	void GameView::render(Renderer* renderer)
 	{
-		game->rebuildChunkMeshes(renderer);
+		auto perspectiveMatrix = glm::perspective(glm::radians(55.0f), (float)application->getWindowWidth() / (float)application->getWindowHeight(), 0.1f, 1000.0f);
+		auto viewMatrix = camera.getViewMatrix();
+
+		renderer->beginFrame();
+		game->rebuildChunkMeshes(renderer, Frustum(perspectiveMatrix * viewMatrix), camera.getPosition());
 
-		glClearColor(0.8f, 0.9f, 1.0f, 1.0f);
+		glm::vec3 skyColor(0.8f, 0.9f, 1.0f);
+		glClearColor(skyColor.r, skyColor.g, skyColor.b, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glEnable(GL_DEPTH_TEST);
 		glEnable(GL_CULL_FACE);
 		glFrontFace(GL_CCW);
 		glDisable(GL_BLEND);
 
-		auto perspectiveMatrix = glm::perspective(glm::radians(55.0f), (float)application->getWindowWidth() / (float)application->getWindowHeight(), 0.1f, 1000.0f);
-		auto viewMatrix = camera.getViewMatrix();
-
-		renderer->renderTerrain(perspectiveMatrix, viewMatrix, game->getChunkMeshes(), application->getSettings()->visibleChunkRadius, camera.getPosition());
+		auto terrainStats = renderer->renderTerrain(perspectiveMatrix, viewMatrix, game->getChunkBufferArena(), game->getChunkMeshes(), application->getSettings()->visibleChunkRadius, camera.getPosition());
+		glm::vec2 horizonFogRange(application->getSettings()->visibleChunkRadius * Chunk::MaxWidth, application->getSettings()->horizonChunkRadius * Chunk::MaxWidth);
+		renderer->renderHorizon(perspectiveMatrix, viewMatrix, game->getHorizonMesh(), camera.getPosition(), skyColor, horizonFogRange);
 		if (currentBlockSelection.isSelected) {
 			renderer->renderCubeOutline(perspectiveMatrix, viewMatrix, (glm::vec3)currentBlockSelection.coordinate + glm::vec3(0.5f, 0.5f, 0.5f));
 		}
@@ -241,14 +253,28 @@ namespace yamc
 		glEnable(GL_BLEND);
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		auto guiProjectionMatrix = glm::ortho(0.0f, (float)application->getWindowWidth(), (float)application->getWindowHeight(), 0.0f, -1000.0f, 1000.0f);
-		renderer->renderText(guiProjectionMatrix, "FPS:" + std::to_string(application->getCurrentFPS()), glm::vec3(1, 1, 1),  glm::vec2(10, 10), 2);
+		renderer->renderText("FPS:" + std::to_string(application->getCurrentFPS()), glm::vec3(1, 1, 1),  glm::vec2(10, 10), 2);
 
 		auto pos = player.boundingBox.center;
-		renderer->renderText(guiProjectionMatrix, "X:" + std::to_string(pos.x) + ", Y:" + std::to_string(pos.y) + ", Z:" + std::to_string(pos.z), glm::vec3(1, 1, 1), glm::vec2(10, 30), 2);
+		renderer->renderText("X:" + std::to_string(pos.x) + ", Y:" + std::to_string(pos.y) + ", Z:" + std::to_string(pos.z), glm::vec3(1, 1, 1), glm::vec2(10, 30), 2);
 		int chunksCount = game->getTerrain().getChunks().size();
-		renderer->renderText(guiProjectionMatrix, "CHUNKS IN MEMORY:" + std::to_string(chunksCount), glm::vec3(1, 1, 1), glm::vec2(10, 50), 2);
+		auto generationStats = game->getGenerationStats();
+		renderer->renderText("CHUNKS IN MEMORY:" + std::to_string(chunksCount) + ", LOADING:" + std::to_string(game->getPendingGenerationCount()) + ", QUEUED:" + std::to_string(generationStats.requestsQueued) + ", DUPLICATES:" + std::to_string(generationStats.duplicatesAvoided) + ", CANCELLED:" + std::to_string(generationStats.requestsCancelled) + ", PREFETCHED:" + std::to_string(game->getPrefetchedChunkCount()) + "/" + std::to_string(generationStats.prefetchesQueued) + ", FIRST VISIBLE:" + std::to_string((int)game->getFirstVisibleChunkTime()) + "MS", glm::vec3(1, 1, 1), glm::vec2(10, 50), 2);
+		auto poolStats = game->getTerrain().getChunkPool().getStats();
+		renderer->renderText("CHUNK POOL HITS:" + std::to_string(poolStats.chunkHits + poolStats.sectionHits + poolStats.indicesHits) + ", MISSES:" + std::to_string(poolStats.chunkMisses + poolStats.sectionMisses + poolStats.indicesMisses), glm::vec3(1, 1, 1), glm::vec2(10, 70), 2);
+		auto meshingMode = game->isGreedyMeshingEnabled() ? "GREEDY" : "NAIVE";
+		renderer->renderText("TRIANGLES:" + std::to_string(game->getTerrainTriangleCount()) + " (" + meshingMode + "), HORIZON SAMPLES:" + std::to_string(game->getHorizonSampleCount()), glm::vec3(1, 1, 1), glm::vec2(10, 90), 2);
+		auto meshingStats = game->getMeshingStats();
+		renderer->renderText("MESHING QUEUE:" + std::to_string(game->getPendingMeshingCount()) + ", DEFERRED:" + std::to_string(game->getDeferredMeshingCount()) + ", UPLOAD QUEUE:" + std::to_string(game->getQueuedMeshUploadCount()) + ", BUILT:" + std::to_string(meshingStats.chunksBuilt) + ", STALE:" + std::to_string(meshingStats.staleRequestsSkipped + meshingStats.staleResultsDiscarded), glm::vec3(1, 1, 1), glm::vec2(10, 110), 2);
+		renderer->renderText("CHUNKS TESTED:" + std::to_string(terrainStats.chunksTested) + ", CULLED:" + std::to_string(terrainStats.chunksCulled) + ", DRAWN:" + std::to_string(terrainStats.chunksDrawn), glm::vec3(1, 1, 1), glm::vec2(10, 130), 2);
+		renderer->renderText("SECTIONS TESTED:" + std::to_string(terrainStats.sectionsTested) + ", CULLED:" + std::to_string(terrainStats.sectionsCulled) + ", OCCLUDED:" + std::to_string(terrainStats.sectionsOccluded) + ", DRAWN:" + std::to_string(terrainStats.sectionsDrawn) + ", DRAW CALLS:" + std::to_string(terrainStats.drawCalls) + " (" + std::to_string(terrainStats.drawRanges) + " RANGES), SKIPPED STATE CHANGES:" + std::to_string(renderer->getSkippedStateChangeCount()), glm::vec3(1, 1, 1), glm::vec2(10, 150), 2);
+		auto arenaStats = game->getChunkBufferArena().getStats();
+		uint32_t freeVertices = arenaStats.vertexCapacity - arenaStats.vertexUsed;
+		int fragmentation = freeVertices > 0 ? 100 - (int)(100ull * arenaStats.largestFreeVertexRange / freeVertices) : 0;
+		renderer->renderText("ARENA VERTICES:" + std::to_string(arenaStats.vertexUsed) + "/" + std::to_string(arenaStats.vertexCapacity) + ", INDICES:" + std::to_string(arenaStats.indexUsed) + "/" + std::to_string(arenaStats.indexCapacity) + ", FREE RANGES:" + std::to_string(arenaStats.vertexFreeRanges + arenaStats.indexFreeRanges) + ", FRAGMENTATION:" + std::to_string(fragmentation) + "%, STALLS:" + std::to_string(arenaStats.stagingStalls), glm::vec3(1, 1, 1), glm::vec2(10, 170), 2);
 		renderer->renderCross(guiProjectionMatrix, glm::vec2(application->getWindowWidth() / 2, application->getWindowHeight() / 2));
-		renderer->renderInventoryHotbar(guiProjectionMatrix, glm::vec2(application->getWindowWidth() / 2, application->getWindowHeight() - 50), inventory);
+		renderer->renderInventoryHotbar(glm::vec2(application->getWindowWidth() / 2, application->getWindowHeight() - 50), inventory);
+		renderer->flushUI(guiProjectionMatrix);
 	}
 
 	void GameView::destroy()
@@ -19,6 +19,7 @@ namespace yamc
 		void render(Renderer* renderer) override;
 		void scroll(double delta) override;
 		void onMouseClick(int button, int mods) override;
+		void onKeyPress(int key, int mods) override;
 		void destroy() override;
 
 		~GameView() override;
@@ -0,0 +1,116 @@
+#include "HorizonMap.h"
+#include "Terrain.h"
+#include <algorithm>
+
+namespace yamc
+{
+	HorizonMap::HorizonMap() :
+		isValid(false),
+		centerChunk(0, 0),
+		innerChunkRadius(0),
+		outerChunkRadius(0),
+		seed(0),
+		minSample(0, 0),
+		samplesPerSide(0),
+		sampledHeightCount(0)
+	{
+	}
+
+	bool HorizonMap::update(const glm::ivec2& centerChunk, int innerChunkRadius, int outerChunkRadius, int seed)
+	{
+		if (isValid && this->centerChunk == centerChunk && this->innerChunkRadius == innerChunkRadius &&
+			this->outerChunkRadius == outerChunkRadius && this->seed == seed) {
+			return false;
+		}
+
+		bool canReuse = isValid && this->seed == seed;
+		glm::ivec2 previousMinSample = minSample;
+		int previousSamplesPerSide = samplesPerSide;
+		std::swap(heights, previousHeights);
+
+		this->centerChunk = centerChunk;
+		this->innerChunkRadius = innerChunkRadius;
+		this->outerChunkRadius = outerChunkRadius;
+		this->seed = seed;
+		minSample = (centerChunk - outerChunkRadius) * CellsPerChunk;
+		samplesPerSide = (outerChunkRadius * 2 + 1) * CellsPerChunk + 1;
+		sampledHeightCount = 0;
+		heights.resize(samplesPerSide * samplesPerSide);
+
+		for (int z = 0; z < samplesPerSide; z++) {
+			for (int x = 0; x < samplesPerSide; x++) {
+				glm::ivec2 sample = minSample + glm::ivec2(x, z);
+				glm::ivec2 previous = sample - previousMinSample;
+				if (canReuse && previous.x >= 0 && previous.x < previousSamplesPerSide && previous.y >= 0 && previous.y < previousSamplesPerSide) {
+					heights[z * samplesPerSide + x] = previousHeights[previous.y * previousSamplesPerSide + previous.x];
+				}
+				else {
+					heights[z * samplesPerSide + x] = getSurfaceHeight(sample.x * CellSize, sample.y * CellSize, seed) + 1;
+					sampledHeightCount++;
+				}
+			}
+		}
+
+		isValid = true;
+		return true;
+	}
+
+	float HorizonMap::getHeight(int x, int z) const
+	{
+		x = glm::clamp(x, 0, samplesPerSide - 1);
+		z = glm::clamp(z, 0, samplesPerSide - 1);
+		return heights[z * samplesPerSide + x];
+	}
+
+	bool HorizonMap::isCellCovered(int x, int z) const
+	{
+		int minCell = -innerChunkRadius * CellsPerChunk;
+		int maxCell = (innerChunkRadius + 1) * CellsPerChunk;
+		glm::ivec2 cell = minSample + glm::ivec2(x, z) - centerChunk * CellsPerChunk;
+		return cell.x >= minCell && cell.x < maxCell && cell.y >= minCell && cell.y < maxCell;
+	}
+
+	void HorizonMap::buildMesh(std::vector<glm::vec3>& positions, std::vector<glm::vec2>& shading, std::vector<uint32_t>& indices) const
+	{
+		positions.clear();
+		shading.clear();
+		indices.clear();
+
+		if (!isValid) {
+			return;
+		}
+
+		for (int z = 0; z < samplesPerSide; z++) {
+			for (int x = 0; x < samplesPerSide; x++) {
+				glm::ivec2 sample = minSample + glm::ivec2(x, z);
+				positions.push_back(glm::vec3(sample.x * CellSize, getHeight(x, z), sample.y * CellSize));
+
+				glm::vec3 normal = glm::normalize(glm::vec3(getHeight(x - 1, z) - getHeight(x + 1, z), CellSize * 2, getHeight(x, z - 1) - getHeight(x, z + 1)));
+				float steepness = glm::clamp((1.0f - normal.y) * 4.0f, 0.0f, 1.0f);
+				shading.push_back(glm::vec2(0.6f + 0.4f * normal.y, steepness));
+			}
+		}
+
+		for (int z = 0; z < samplesPerSide - 1; z++) {
+			for (int x = 0; x < samplesPerSide - 1; x++) {
+				if (isCellCovered(x, z)) {
+					continue;
+				}
+
+				uint32_t topLeft = z * samplesPerSide + x;
+				uint32_t bottomLeft = topLeft + samplesPerSide;
+				indices.push_back(topLeft);
+				indices.push_back(bottomLeft);
+				indices.push_back(bottomLeft + 1);
+				indices.push_back(topLeft);
+				indices.push_back(bottomLeft + 1);
+				indices.push_back(topLeft + 1);
+			}
+		}
+	}
+
+	uint32_t HorizonMap::getSampledHeightCount() const
+	{
+		return sampledHeightCount;
+	}
+}
\ No newline at end of file
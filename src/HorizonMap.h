@@ -0,0 +1,40 @@
+#ifndef YAMC_HORIZON_MAP_H
+#define YAMC_HORIZON_MAP_H
+
+#include "Chunk.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <stdint.h>
+
+namespace yamc
+{
+	class HorizonMap
+	{
+	public:
+		static constexpr int CellSize = 8;
+		static constexpr int CellsPerChunk = Chunk::MaxWidth / CellSize;
+
+		HorizonMap();
+
+		bool update(const glm::ivec2& centerChunk, int innerChunkRadius, int outerChunkRadius, int seed);
+		void buildMesh(std::vector<glm::vec3>& positions, std::vector<glm::vec2>& shading, std::vector<uint32_t>& indices) const;
+		uint32_t getSampledHeightCount() const;
+
+	private:
+		bool isValid;
+		glm::ivec2 centerChunk;
+		int innerChunkRadius;
+		int outerChunkRadius;
+		int seed;
+		glm::ivec2 minSample;
+		int samplesPerSide;
+		uint32_t sampledHeightCount;
+		std::vector<float> heights;
+		std::vector<float> previousHeights;
+
+		float getHeight(int x, int z) const;
+		bool isCellCovered(int x, int z) const;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -5,7 +5,9 @@
 namespace yamc
 {
 	Mesh::Mesh() :
-		indicesCount(0)
+		indicesCount(0),
+		vertexBufferCapacity(0),
+		indexBufferCapacity(0)
 	{
 		glGenVertexArrays(1, &vaoID);
 		glGenBuffers(1, &vertexBufferID);
@@ -15,6 +17,8 @@ namespace yamc
 	Mesh::Mesh(Mesh&& other) noexcept
 	{
 		indicesCount = other.indicesCount;
+		vertexBufferCapacity = other.vertexBufferCapacity;
+		indexBufferCapacity = other.indexBufferCapacity;
 		vaoID = other.vaoID;
 		vertexBufferID = other.vertexBufferID;
 		indexBufferID = other.indexBufferID;
@@ -23,71 +27,58 @@ namespace yamc
 		other.indexBufferID = 0;
 	}
 
-	void Mesh::setData(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices)
+	void Mesh::reserveStorage(uint32_t target, size_t& capacity, size_t size)
 	{
-		glBindVertexArray(vaoID);
-
-		size_t positionsSize = positions.size() * sizeof(glm::vec3);
-
-		glBindBuffer(GL_ARRAY_BUFFER, vertexBufferID);
-		glBufferData(GL_ARRAY_BUFFER, positionsSize, nullptr, GL_STATIC_DRAW);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, positionsSize, positions.data());
-
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-		glEnableVertexAttribArray(0);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
-
-		glBindVertexArray(0);
+		if (size <= capacity) {
+			return;
+		}
 
-		indicesCount = indices.size();
+		capacity = (std::max)(size, capacity * 2);
+		glBufferData(target, capacity, nullptr, GL_STATIC_DRAW);
 	}
 
-	void Mesh::setData(const std::vector<glm::vec3>& positions, const std::vector<glm::vec2>& uvs, const std::vector<uint32_t>& indices)
+	void Mesh::setData(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices)
 	{
 		glBindVertexArray(vaoID);
 
 		size_t positionsSize = positions.size() * sizeof(glm::vec3);
-		size_t uvsSize = uvs.size() * sizeof(glm::vec2);
 
 		glBindBuffer(GL_ARRAY_BUFFER, vertexBufferID);
-		glBufferData(GL_ARRAY_BUFFER, positionsSize + uvsSize, nullptr, GL_STATIC_DRAW);
+		reserveStorage(GL_ARRAY_BUFFER, vertexBufferCapacity, positionsSize);
 		glBufferSubData(GL_ARRAY_BUFFER, 0, positionsSize, positions.data());
-		glBufferSubData(GL_ARRAY_BUFFER, positionsSize, uvsSize, uvs.data());
 
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)positionsSize);
 		glEnableVertexAttribArray(0);
-		glEnableVertexAttribArray(1);
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+		reserveStorage(GL_ELEMENT_ARRAY_BUFFER, indexBufferCapacity, indices.size() * sizeof(uint32_t));
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(uint32_t), indices.data());
 
 		glBindVertexArray(0);
 
 		indicesCount = indices.size();
 	}
 
-	void Mesh::setData(const std::vector<glm::vec4>& positions, const std::vector<glm::vec2>& uvs, const std::vector<uint32_t>& indices)
+	void Mesh::setData(const std::vector<glm::vec3>& positions, const std::vector<glm::vec2>& uvs, const std::vector<uint32_t>& indices)
 	{
 		glBindVertexArray(vaoID);
 
-		size_t positionsSize = positions.size() * sizeof(glm::vec4);
+		size_t positionsSize = positions.size() * sizeof(glm::vec3);
 		size_t uvsSize = uvs.size() * sizeof(glm::vec2);
 
 		glBindBuffer(GL_ARRAY_BUFFER, vertexBufferID);
-		glBufferData(GL_ARRAY_BUFFER, positionsSize + uvsSize, nullptr, GL_STATIC_DRAW);
+		reserveStorage(GL_ARRAY_BUFFER, vertexBufferCapacity, positionsSize + uvsSize);
 		glBufferSubData(GL_ARRAY_BUFFER, 0, positionsSize, positions.data());
 		glBufferSubData(GL_ARRAY_BUFFER, positionsSize, uvsSize, uvs.data());
 
-		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
 		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)positionsSize);
 		glEnableVertexAttribArray(0);
 		glEnableVertexAttribArray(1);
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+		reserveStorage(GL_ELEMENT_ARRAY_BUFFER, indexBufferCapacity, indices.size() * sizeof(uint32_t));
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(uint32_t), indices.data());
 
 		glBindVertexArray(0);
 
@@ -16,7 +16,6 @@ namespace yamc
 
 		void setData(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices);
 		void setData(const std::vector<glm::vec3>& positions, const std::vector<glm::vec2>& uvs, const std::vector<uint32_t>& indices);
-		void setData(const std::vector<glm::vec4>& positions, const std::vector<glm::vec2>& uvs, const std::vector<uint32_t>& indices);
 
 		uint32_t getVAO() const;
 		uint32_t getIndicesCount() const;
@@ -28,6 +27,10 @@ namespace yamc
 		uint32_t vertexBufferID;
 		uint32_t indexBufferID;
 		uint32_t indicesCount;
+		size_t vertexBufferCapacity;
+		size_t indexBufferCapacity;
+
+		static void reserveStorage(uint32_t target, size_t& capacity, size_t size);
 	};
 }
 
@@ -1,5 +1,7 @@
 #include "MeshBuilder.h"
+#include "Visibility.h"
 #include <algorithm>
+#include <iterator>
 
 namespace yamc
 {
@@ -31,19 +33,6 @@ namespace yamc
 		{ {-1, -1, -1}, {-1, -1, 1}, {-1, 1, 1}, {-1, 1, -1} } //left
 	};
 
-	const float MeshBuilder::BlockFaceIlluminance[6] =
-	{
-		1.0f,
-		0.1f,
-		0.5f,
-		0.8f,
-		0.7f,
-		0.4f
-	};
-
-	const float MeshBuilder::BlockWidth = 1.0f;
-	const float MeshBuilder::BlockHalfWidth = BlockWidth / 2;
-
 	MeshBuilder::MeshBuilder(const AtlasTexture& atlas) :
 		atlas(atlas)
 	{
@@ -57,89 +46,408 @@ namespace yamc
 		return 3 - (side1 + side2 + corner);
 	}
 
-	void MeshBuilder::addCubeBlock(std::vector<glm::vec4>& positions,
-		std::vector<glm::vec2>& uvs,
+	bool isBlockEnclosed(const uint32_t* blocks, int index, int y)
+	{
+		constexpr int StrideZ = ChunkNeighborhood::Width;
+		constexpr int StrideY = ChunkNeighborhood::Width * ChunkNeighborhood::Length;
+
+		return blocks[index + StrideY] != 0 &&
+			(y == 0 || blocks[index - StrideY] != 0) &&
+			blocks[index + StrideZ] != 0 &&
+			blocks[index - StrideZ] != 0 &&
+			blocks[index + 1] != 0 &&
+			blocks[index - 1] != 0;
+	}
+
+	uint32_t getAtlasIndex(uint32_t id, int face)
+	{
+		const int* atlasIndices = id < std::size(MeshBuilder::BlockAtlasIndicesByType) ? MeshBuilder::BlockAtlasIndicesByType[id] : MeshBuilder::BlockAtlasIndicesByType[0];
+		return atlasIndices[(std::min)(face, 2)];
+	}
+
+	bool MeshBuilder::isFaceVisible(const ChunkNeighborhood& neighborhood, const glm::ivec3& localCoordinate, int face)
+	{
+		auto adjuscentBlock = localCoordinate + BlockFaceNormals[face];
+		return adjuscentBlock.y >= 0 && neighborhood.getBlock(adjuscentBlock.x, adjuscentBlock.y, adjuscentBlock.z) == 0;
+	}
+
+	void MeshBuilder::calculateFaceAO(const ChunkNeighborhood& neighborhood, const glm::ivec3& localCoordinate, int face, int* ao)
+	{
+		for (int i = 0; i < 4; i++) {
+			auto vertexOffset = BlockFaceVertices[face][i];
+			auto a1 = localCoordinate + glm::ivec3(vertexOffset.x, vertexOffset.y, 0);
+			auto a2 = localCoordinate + glm::ivec3(0, vertexOffset.y, vertexOffset.z);
+			auto aCorner = localCoordinate + glm::ivec3(vertexOffset.x, vertexOffset.y, vertexOffset.z);
+			int side1 = neighborhood.getBlock(a1.x, a1.y, a1.z) != 0 ? 1 : 0;
+			int side2 = neighborhood.getBlock(a2.x, a2.y, a2.z) != 0 ? 1 : 0;
+			int corner = neighborhood.getBlock(aCorner.x, aCorner.y, aCorner.z) != 0 ? 1 : 0;
+			ao[i] = calculateAO(side1, side2, corner);
+		}
+	}
+
+	void MeshBuilder::addFace(std::vector<glm::uvec2>& vertices,
 		std::vector<uint32_t>& indices,
-		const glm::vec3 center,
-		const glm::ivec3 worldCoordinate,
+		const glm::ivec3 localCoordinate,
+		int face,
+		const int* ao,
+		uint32_t atlasIndex,
+		int width,
+		int height) const
+	{
+		uint32_t baseIndex = vertices.size();
+
+		glm::ivec3 uAxis = (BlockFaceVertices[face][1] - BlockFaceVertices[face][0]) * 0.5f;
+		glm::ivec3 vAxis = (BlockFaceVertices[face][2] - BlockFaceVertices[face][1]) * 0.5f;
+		glm::ivec3 uExtent = uAxis * (width - 1);
+		glm::ivec3 vExtent = vAxis * (height - 1);
+		glm::ivec3 extents[4] = { glm::ivec3(0), uExtent, uExtent + vExtent, vExtent };
+		glm::uvec2 repeats[4] = { glm::uvec2(0, height), glm::uvec2(width, height), glm::uvec2(width, 0), glm::uvec2(0, 0) };
+
+		uint32_t tileColumn = atlasIndex % atlas.getTilesPerRow();
+		uint32_t tileRow = atlasIndex / atlas.getTilesPerRow();
+
+		for (int i = 0; i < 4; i++) {
+			glm::ivec3 corner = (glm::ivec3(BlockFaceVertices[face][i]) + 1) / 2;
+			glm::uvec3 position(localCoordinate + corner + extents[i]);
+			uint32_t vertexAO = ao != nullptr ? ao[i] : MaxAO;
+
+			uint32_t geometry = position.x | (position.y << 5) | (position.z << 13) | (face << 18) | (vertexAO << 21);
+			uint32_t texture = tileColumn | (tileRow << 8) | (repeats[i].x << 16) | (repeats[i].y << 21);
+			vertices.push_back(glm::uvec2(geometry, texture));
+		}
+
+		indices.push_back(baseIndex + 0);
+		indices.push_back(baseIndex + 1);
+		indices.push_back(baseIndex + 2);
+		indices.push_back(baseIndex + 0);
+		indices.push_back(baseIndex + 2);
+		indices.push_back(baseIndex + 3);
+	}
+
+	void MeshBuilder::addCubeBlock(std::vector<glm::uvec2>& vertices,
+		std::vector<uint32_t>& indices,
+		const glm::ivec3 localCoordinate,
 		uint32_t id,
-		const Terrain* terrain) const
+		const ChunkNeighborhood* neighborhood) const
 	{
 		for (int face = 0; face < 6; face++) {
-			auto normal = BlockFaceNormals[face];
-			auto adjuscentBlock = worldCoordinate + normal;
-			if (terrain != nullptr && (adjuscentBlock.y < 0 || terrain->getBlock(adjuscentBlock.x, adjuscentBlock.y, adjuscentBlock.z) != 0)) {
+			if (neighborhood == nullptr) {
+				addFace(vertices, indices, localCoordinate, face, nullptr, getAtlasIndex(id, face), 1, 1);
+				continue;
+			}
+
+			if (!isFaceVisible(*neighborhood, localCoordinate, face)) {
 				continue;
 			}
 
-			const int* atlasIndices = id < sizeof(BlockAtlasIndicesByType) ? BlockAtlasIndicesByType[id] : BlockAtlasIndicesByType[0];
-
-			uint32_t baseIndex = positions.size();
-			float illuminance = BlockFaceIlluminance[face];
-
-			for (int i = 0; i < 4; i++) {
-				auto vertexOffset = BlockFaceVertices[face][i];
-				float vertexIlluminance = illuminance;
-				if (terrain != nullptr) {
-					auto a1 = worldCoordinate + glm::ivec3(vertexOffset.x, vertexOffset.y, 0);
-					auto a2 = worldCoordinate + glm::ivec3(0, vertexOffset.y, vertexOffset.z);
-					auto aCorner = worldCoordinate + glm::ivec3(vertexOffset.x, vertexOffset.y, vertexOffset.z);
-					int side1 = terrain->getBlock(a1.x, a1.y, a1.z) != 0 ? 1 : 0;
-					int side2 = terrain->getBlock(a2.x, a2.y, a2.z) != 0 ? 1 : 0;
-					int corner = terrain->getBlock(aCorner.x, aCorner.y, aCorner.z) != 0 ? 1 : 0;
-					vertexIlluminance += calculateAO(side1, side2, corner) * 0.1f;
-					vertexIlluminance -= 0.3f;
+			int ao[4];
+			calculateFaceAO(*neighborhood, localCoordinate, face, ao);
+			addFace(vertices, indices, localCoordinate, face, ao, getAtlasIndex(id, face), 1, 1);
+		}
+	}
+
+	void MeshBuilder::addSectionBlocks(std::vector<glm::uvec2>& vertices,
+		std::vector<uint32_t>& indices,
+		const ChunkNeighborhood& neighborhood,
+		int sectionIndex) const
+	{
+		const uint32_t* blocks = neighborhood.blocks.data();
+		int minY = sectionIndex * Chunk::SectionHeight;
+		for (int y = minY; y < minY + Chunk::SectionHeight; y++) {
+			for (int z = 0; z < Chunk::MaxLength; z++) {
+				for (int x = 0; x < Chunk::MaxWidth; x++) {
+					int index = ChunkNeighborhood::getIndex(x, y, z);
+					uint32_t id = blocks[index];
+					if (id > 0 && !isBlockEnclosed(blocks, index, y)) {
+						addCubeBlock(vertices, indices, glm::ivec3(x, y, z), id, &neighborhood);
+					}
 				}
-				
-				auto position = glm::vec3(center + BlockFaceVertices[face][i] * BlockHalfWidth);
-				positions.push_back(glm::vec4(position, vertexIlluminance));
 			}
+		}
+	}
 
-			indices.push_back(baseIndex + 0);
-			indices.push_back(baseIndex + 1);
-			indices.push_back(baseIndex + 2);
-			indices.push_back(baseIndex + 0);
-			indices.push_back(baseIndex + 2);
-			indices.push_back(baseIndex + 3);
+	int getAxis(const glm::ivec3& direction)
+	{
+		return direction.x != 0 ? 0 : (direction.y != 0 ? 1 : 2);
+	}
+
+	void MeshBuilder::addSectionGreedyFaces(std::vector<glm::uvec2>& vertices,
+		std::vector<uint32_t>& indices,
+		const ChunkNeighborhood& neighborhood,
+		int sectionIndex) const
+	{
+		constexpr int Size = ChunkSection::Size;
+		uint32_t mask[Size * Size];
+
+		int minY = sectionIndex * Chunk::SectionHeight;
+
+		for (int face = 0; face < 6; face++) {
+			glm::ivec3 uDirection = (BlockFaceVertices[face][1] - BlockFaceVertices[face][0]) * 0.5f;
+			glm::ivec3 vDirection = (BlockFaceVertices[face][2] - BlockFaceVertices[face][1]) * 0.5f;
+			int normalAxis = getAxis(BlockFaceNormals[face]);
+			int uAxis = getAxis(uDirection);
+			int vAxis = getAxis(vDirection);
+			bool isUReversed = uDirection[uAxis] < 0;
+			bool isVReversed = vDirection[vAxis] < 0;
+
+			for (int slice = 0; slice < Size; slice++) {
+				for (int j = 0; j < Size; j++) {
+					for (int i = 0; i < Size; i++) {
+						glm::ivec3 coordinate;
+						coordinate[normalAxis] = slice;
+						coordinate[uAxis] = isUReversed ? Size - 1 - i : i;
+						coordinate[vAxis] = isVReversed ? Size - 1 - j : j;
+						coordinate.y += minY;
+
+						uint32_t& key = mask[j * Size + i];
+						key = 0;
+
+						uint32_t id = neighborhood.getBlock(coordinate.x, coordinate.y, coordinate.z);
+						if (id == 0 || !isFaceVisible(neighborhood, coordinate, face)) {
+							continue;
+						}
+
+						int ao[4];
+						calculateFaceAO(neighborhood, coordinate, face, ao);
+						key = 1 + ((getAtlasIndex(id, face) << 8) | ao[0] | (ao[1] << 2) | (ao[2] << 4) | (ao[3] << 6));
+					}
+				}
+
+				for (int j = 0; j < Size; j++) {
+					for (int i = 0; i < Size; i++) {
+						uint32_t key = mask[j * Size + i];
+						if (key == 0) {
+							continue;
+						}
+
+						uint32_t faceData = key - 1;
+						int ao[4] = { (int)(faceData & 3), (int)((faceData >> 2) & 3), (int)((faceData >> 4) & 3), (int)((faceData >> 6) & 3) };
+
+						int width = 1;
+						if (ao[0] == ao[1] && ao[3] == ao[2]) {
+							while (i + width < Size && mask[j * Size + i + width] == key) {
+								width++;
+							}
+						}
+
+						int height = 1;
+						if (ao[1] == ao[2] && ao[0] == ao[3]) {
+							for (; j + height < Size; height++) {
+								uint32_t* row = &mask[(j + height) * Size + i];
+								if (std::count(row, row + width, key) != width) {
+									break;
+								}
+							}
+						}
+
+						for (int dj = 0; dj < height; dj++) {
+							std::fill(&mask[(j + dj) * Size + i], &mask[(j + dj) * Size + i + width], 0);
+						}
+
+						glm::ivec3 coordinate;
+						coordinate[normalAxis] = slice;
+						coordinate[uAxis] = isUReversed ? Size - 1 - i : i;
+						coordinate[vAxis] = isVReversed ? Size - 1 - j : j;
+						coordinate.y += minY;
+
+						addFace(vertices, indices, coordinate, face, ao, faceData >> 8, width, height);
+					}
+				}
+			}
+		}
+	}
+
+	static int getLodCellIndex(const glm::ivec3& cell, int scale)
+	{
+		return (cell.y * (Chunk::MaxLength / scale) + cell.z) * (Chunk::MaxWidth / scale) + cell.x;
+	}
+
+	void MeshBuilder::downsampleChunk(const ChunkNeighborhood& neighborhood, int scale, std::vector<uint32_t>& cells)
+	{
+		glm::ivec3 size(Chunk::MaxWidth / scale, Chunk::MaxHeight / scale, Chunk::MaxLength / scale);
+		int minSolidCount = (scale * scale * scale + 1) / 2;
+
+		cells.assign(size.x * size.y * size.z, 0);
+
+		for (int cy = 0; cy < size.y; cy++) {
+			if ((neighborhood.sectionMask & (1 << (cy * scale / Chunk::SectionHeight))) == 0) {
+				continue;
+			}
 
-			int atlasIndex = atlasIndices[(std::min)(face, 2)];
-			auto uvMin = atlas.getTileOffset(atlasIndex);
-			auto uvMax = uvMin + atlas.getUVScale();
+			for (int cz = 0; cz < size.z; cz++) {
+				for (int cx = 0; cx < size.x; cx++) {
+					int solidCount = 0;
+					uint32_t topId = 0;
+					for (int y = (cy + 1) * scale - 1; y >= cy * scale; y--) {
+						for (int z = cz * scale; z < (cz + 1) * scale; z++) {
+							for (int x = cx * scale; x < (cx + 1) * scale; x++) {
+								uint32_t id = neighborhood.getBlock(x, y, z);
+								if (id != 0) {
+									solidCount++;
+									topId = topId == 0 ? id : topId;
+								}
+							}
+						}
+					}
 
-			uvs.push_back({ uvMin.x, uvMax.y });
-			uvs.push_back({ uvMax.x, uvMax.y });
-			uvs.push_back({ uvMax.x, uvMin.y });
-			uvs.push_back({ uvMin.x, uvMin.y });
+					if (solidCount >= minSolidCount) {
+						cells[getLodCellIndex(glm::ivec3(cx, cy, cz), scale)] = topId;
+					}
+				}
+			}
 		}
 	}
 
-	void MeshBuilder::rebuildChunk(uint64_t chunkKey, Chunk* chunk, const Terrain* terrain, Mesh* mesh) const
+	bool MeshBuilder::isLodNeighborSolid(const ChunkNeighborhood& neighborhood, const std::vector<uint32_t>& cells, int scale, const glm::ivec3& cell, int face)
 	{
-		auto chunkOffset = getChunkOffset(chunkKey);
+		glm::ivec3 size(Chunk::MaxWidth / scale, Chunk::MaxHeight / scale, Chunk::MaxLength / scale);
+		glm::ivec3 next = cell + BlockFaceNormals[face];
 
-		static std::vector<glm::vec4> positions;
-		static std::vector<glm::vec2> uvs;
-		static std::vector<uint32_t> indices;
+		if (next.y < 0) {
+			return true;
+		}
 
-		positions.clear();
-		uvs.clear();
-		indices.clear();
+		if (next.y >= size.y) {
+			return false;
+		}
 
-		for (int x = 0; x < Chunk::MaxWidth; x++) {
-			for (int y = 0; y < Chunk::MaxHeight; y++) {
-				for (int z = 0; z < Chunk::MaxLength; z++) {
-					uint32_t id = chunk->getBlock(x, y, z);
-					if (id > 0) {
-						glm::ivec3 worldCoordinate(x + chunkOffset[0] * Chunk::MaxWidth, y, z + chunkOffset[1] * Chunk::MaxLength);
-						glm::vec3 center(x * BlockWidth + BlockHalfWidth, y * BlockWidth + BlockHalfWidth, z * BlockWidth + BlockHalfWidth);
+		if (next.x >= 0 && next.x < size.x && next.z >= 0 && next.z < size.z) {
+			return cells[getLodCellIndex(next, scale)] != 0;
+		}
+
+		// Neighbouring chunks may be meshed at another level, so the border face is kept
+		// unless the whole adjacent slab is solid. It works as a skirt over level seams.
+		glm::ivec3 min = cell * scale;
+		glm::ivec3 max = min + scale;
+		int axis = next.x < 0 || next.x >= size.x ? 0 : 2;
+		min[axis] = next[axis] < 0 ? -1 : size[axis] * scale;
+		max[axis] = min[axis] + 1;
 
-						addCubeBlock(positions, uvs, indices, center, worldCoordinate, id, terrain);
+		for (int y = min.y; y < max.y; y++) {
+			for (int z = min.z; z < max.z; z++) {
+				for (int x = min.x; x < max.x; x++) {
+					if (neighborhood.getBlock(x, y, z) == 0) {
+						return false;
 					}
 				}
 			}
 		}
+		return true;
+	}
+
+	void MeshBuilder::addSectionLodFaces(std::vector<glm::uvec2>& vertices,
+		std::vector<uint32_t>& indices,
+		const ChunkNeighborhood& neighborhood,
+		const std::vector<uint32_t>& cells,
+		int scale,
+		int sectionIndex) const
+	{
+		int cellsPerSection = Chunk::SectionHeight / scale;
+		int cellsPerRow = Chunk::MaxWidth / scale;
+		int rowsPerLayer = Chunk::MaxLength / scale;
+
+		for (int cy = sectionIndex * cellsPerSection; cy < (sectionIndex + 1) * cellsPerSection; cy++) {
+			for (int cz = 0; cz < rowsPerLayer; cz++) {
+				for (int cx = 0; cx < cellsPerRow; cx++) {
+					glm::ivec3 cell(cx, cy, cz);
+					uint32_t id = cells[getLodCellIndex(cell, scale)];
+					if (id == 0) {
+						continue;
+					}
+
+					for (int face = 0; face < 6; face++) {
+						if (isLodNeighborSolid(neighborhood, cells, scale, cell, face)) {
+							continue;
+						}
 
-		mesh->setData(positions, uvs, indices);
+						glm::ivec3 uDirection = (BlockFaceVertices[face][1] - BlockFaceVertices[face][0]) * 0.5f;
+						glm::ivec3 vDirection = (BlockFaceVertices[face][2] - BlockFaceVertices[face][1]) * 0.5f;
+						int normalAxis = getAxis(BlockFaceNormals[face]);
+						int uAxis = getAxis(uDirection);
+						int vAxis = getAxis(vDirection);
+
+						glm::ivec3 coordinate = cell * scale;
+						coordinate[normalAxis] += BlockFaceNormals[face][normalAxis] > 0 ? scale - 1 : 0;
+						coordinate[uAxis] += uDirection[uAxis] < 0 ? scale - 1 : 0;
+						coordinate[vAxis] += vDirection[vAxis] < 0 ? scale - 1 : 0;
+
+						addFace(vertices, indices, coordinate, face, nullptr, getAtlasIndex(id, face), scale, scale);
+					}
+				}
+			}
+		}
 	}
-};
 
+	uint32_t MeshBuilder::getLodLevel(int chunkDistance, int fullDetailRadius)
+	{
+		if (chunkDistance <= fullDetailRadius) {
+			return 0;
+		}
+
+		uint32_t lodLevel = 1;
+		int lodRadius = (std::max)(fullDetailRadius, 1) * 2;
+		while (lodLevel < MaxLodLevel && chunkDistance > lodRadius) {
+			lodLevel++;
+			lodRadius *= 2;
+		}
+		return lodLevel;
+	}
+
+	void MeshBuilder::buildChunk(const ChunkNeighborhood& neighborhood, bool useGreedyMeshing, uint32_t lodLevel, uint8_t sectionMask, ChunkMeshData& meshData) const
+	{
+		auto& vertices = meshData.vertices;
+		auto& indices = meshData.indices;
+
+		vertices.clear();
+		indices.clear();
+
+		int scale = 1 << lodLevel;
+		std::vector<uint32_t> cells;
+		if (lodLevel > 0) {
+			downsampleChunk(neighborhood, scale, cells);
+			sectionMask = Chunk::AllSectionsMask;
+		}
+
+		for (int sectionIndex = 0; sectionIndex < Chunk::SectionCount; sectionIndex++) {
+			IndexRange& range = meshData.sections[sectionIndex];
+			range.offset = indices.size();
+			range.count = 0;
+			meshData.sectionConnectivity[sectionIndex] = 0;
+
+			if ((sectionMask & (1 << sectionIndex)) == 0) {
+				continue;
+			}
+
+			if ((neighborhood.sectionMask & (1 << sectionIndex)) != 0) {
+				if (lodLevel > 0) {
+					addSectionLodFaces(vertices, indices, neighborhood, cells, scale, sectionIndex);
+				}
+				else if (useGreedyMeshing) {
+					addSectionGreedyFaces(vertices, indices, neighborhood, sectionIndex);
+				}
+				else {
+					addSectionBlocks(vertices, indices, neighborhood, sectionIndex);
+				}
+			}
+
+			range.count = indices.size() - range.offset;
+			meshData.sectionConnectivity[sectionIndex] = computeSectionConnectivity(neighborhood, sectionIndex);
+		}
+
+		meshData.lodLevel = lodLevel;
+		meshData.sectionMask = sectionMask;
+	}
+
+	void MeshBuilder::buildQuadIndices(uint32_t vertexCount, std::vector<uint32_t>& indices)
+	{
+		indices.clear();
+		for (uint32_t baseIndex = 0; baseIndex < vertexCount; baseIndex += 4) {
+			indices.push_back(baseIndex + 0);
+			indices.push_back(baseIndex + 1);
+			indices.push_back(baseIndex + 2);
+			indices.push_back(baseIndex + 0);
+			indices.push_back(baseIndex + 2);
+			indices.push_back(baseIndex + 3);
+		}
+	}
+};
\ No newline at end of file
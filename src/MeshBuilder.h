@@ -7,34 +7,90 @@
 #include "Chunk.h"
 #include "Terrain.h"
 #include "Mesh.h"
+#include "ChunkBufferArena.h"
 
 namespace yamc
 {
+	struct IndexRange
+	{
+		uint32_t offset;
+		uint32_t count;
+	};
+
+	struct ChunkMeshData
+	{
+		std::vector<glm::uvec2> vertices;
+		std::vector<uint32_t> indices;
+		IndexRange sections[Chunk::SectionCount];
+		uint16_t sectionConnectivity[Chunk::SectionCount];
+		uint32_t lodLevel;
+		uint8_t sectionMask;
+	};
+
+	struct ChunkMesh
+	{
+		ChunkAllocation allocation;
+		IndexRange sections[Chunk::SectionCount];
+		uint16_t sectionConnectivity[Chunk::SectionCount];
+		uint32_t lodLevel;
+	};
+
 	class MeshBuilder
 	{
 	public:
 		static const int BlockAtlasIndicesByType[4][3];
+		static constexpr uint32_t MaxLodLevel = 3;
 
 		MeshBuilder(const AtlasTexture& atlas);
 
-		void addCubeBlock(std::vector<glm::vec4>& positions, 
-			std::vector<glm::vec2>& uvs, 
+		void addCubeBlock(std::vector<glm::uvec2>& vertices, 
 			std::vector<uint32_t>& indices, 
-			const glm::vec3 center, 
-			const glm::ivec3 worldCoordinate, 
+			const glm::ivec3 localCoordinate, 
 			uint32_t id, 
-			const Terrain* terrain = nullptr) const;
+			const ChunkNeighborhood* neighborhood = nullptr) const;
+
+		void buildChunk(const ChunkNeighborhood& neighborhood, bool useGreedyMeshing, uint32_t lodLevel, uint8_t sectionMask, ChunkMeshData& meshData) const;
 
-		void rebuildChunk(uint64_t chunkKey, Chunk* chunk, const Terrain* terrain, Mesh* mesh) const;
+		static uint32_t getLodLevel(int chunkDistance, int fullDetailRadius);
+		static void buildQuadIndices(uint32_t vertexCount, std::vector<uint32_t>& indices);
 
 	private:
 		static const glm::ivec3 BlockFaceNormals[6];
 		static const glm::vec3 BlockFaceVertices[6][4];
-		static const float BlockFaceIlluminance[6];
-		static const float BlockWidth;
-		static const float BlockHalfWidth;
+		static constexpr uint32_t MaxAO = 3;
 
 		const AtlasTexture& atlas;
+
+		static bool isFaceVisible(const ChunkNeighborhood& neighborhood, const glm::ivec3& localCoordinate, int face);
+		static void calculateFaceAO(const ChunkNeighborhood& neighborhood, const glm::ivec3& localCoordinate, int face, int* ao);
+		static void downsampleChunk(const ChunkNeighborhood& neighborhood, int scale, std::vector<uint32_t>& cells);
+		static bool isLodNeighborSolid(const ChunkNeighborhood& neighborhood, const std::vector<uint32_t>& cells, int scale, const glm::ivec3& cell, int face);
+
+		void addFace(std::vector<glm::uvec2>& vertices,
+			std::vector<uint32_t>& indices,
+			const glm::ivec3 localCoordinate,
+			int face,
+			const int* ao,
+			uint32_t atlasIndex,
+			int width,
+			int height) const;
+
+		void addSectionBlocks(std::vector<glm::uvec2>& vertices,
+			std::vector<uint32_t>& indices,
+			const ChunkNeighborhood& neighborhood,
+			int sectionIndex) const;
+
+		void addSectionGreedyFaces(std::vector<glm::uvec2>& vertices,
+			std::vector<uint32_t>& indices,
+			const ChunkNeighborhood& neighborhood,
+			int sectionIndex) const;
+
+		void addSectionLodFaces(std::vector<glm::uvec2>& vertices,
+			std::vector<uint32_t>& indices,
+			const ChunkNeighborhood& neighborhood,
+			const std::vector<uint32_t>& cells,
+			int scale,
+			int sectionIndex) const;
 	};
 }
 
@@ -13,13 +13,17 @@ namespace yamc
 		isConnected(false),
 		seed(0)
 	{
-
+		backgroundTickMilliseconds = BlockSyncIntervalMilliseconds;
 	}
 
 	void MultiPlayerGame::init()
 	{
+		connectToServer();
 		Game::init();
+	}
 
+	void MultiPlayerGame::connectToServer()
+	{
 		if (initSockets() != 0) {
 			printf("Cannot init sockets.\n");
 			return;
@@ -52,6 +56,17 @@ namespace yamc
 
 	void MultiPlayerGame::update(const glm::vec3& playerPosition, float dt)
 	{
+		{
+			std::lock_guard<std::mutex> receivedGuard(receivedBlockDiffsMutex);
+			if (receivedBlockDiffs.size() > 0) {
+				std::lock_guard<std::mutex> terrainGuard(terrainMutex);
+				for (const auto& blockDiff : receivedBlockDiffs) {
+					terrain.setBlock(blockDiff.x, blockDiff.y, blockDiff.z, blockDiff.type);
+				}
+				receivedBlockDiffs.clear();
+			}
+		}
+
 		Game::update(playerPosition, dt);
 	}
 
@@ -71,7 +86,11 @@ namespace yamc
 	void MultiPlayerGame::setBlock(int x, int y, int z, uint32_t type)
 	{
 		Game::setBlock(x, y, z, type);
-		blockDiffsToSend.push({ x, y, z, type });
+		{
+			std::lock_guard<std::mutex> guard(blockDiffsToSendMutex);
+			blockDiffsToSend.push({ x, y, z, type });
+		}
+		notifyBackgroundWork();
 	}
 
 	bool MultiPlayerGame::requestConnection()
@@ -114,19 +133,18 @@ namespace yamc
 		}
 
 		uint8_t responseCode = packageBuffer.readByte();
-		std::vector<BlockDiff> blockDiffs;
-		readBlockDiffsFromPackage(packageBuffer, blockDiffs);
-		if (blockDiffs.size() > 0) {
-			std::lock_guard<std::mutex> guard(terrainMutex);
-			for (const auto& blockDiff : blockDiffs) {
-				terrain.setBlock(blockDiff.x, blockDiff.y, blockDiff.z, blockDiff.type);
-			}
-		}
+		std::lock_guard<std::mutex> guard(receivedBlockDiffsMutex);
+		readBlockDiffsFromPackage(packageBuffer, receivedBlockDiffs);
 	}
 
 	Chunk* MultiPlayerGame::loadChunk(uint64_t key)
 	{
-		auto chunk = new Chunk();
+		std::lock_guard<std::mutex> guard(connectionMutex);
+		if (!isConnected) {
+			return nullptr;
+		}
+
+		auto chunk = terrain.getChunkPool().acquireChunk();
 
 		packageBuffer.rewind();
 		packageBuffer.writeByte((uint8_t)RequestCodes::LoadChunk);
@@ -143,6 +161,7 @@ namespace yamc
 		uint8_t responseCode = packageBuffer.readByte();
 		if (responseCode == (uint8_t)ResponseCodes::ChunkDataStart) {
 			size_t totalSize = packageBuffer.readUint32();
+			size_t chunkDataSize = packageBuffer.readUint32();
 			printf("Received %d bytes of data.\n", (int)totalSize);
 			std::vector<uint8_t> compressedData(totalSize);
 
@@ -162,7 +181,13 @@ namespace yamc
 				offset += bytesToRead;
 			}
 
-			decompressData(compressedData.data(), compressedData.size(), chunk->getData(), Chunk::MaxHeight * Chunk::MaxLength * Chunk::MaxWidth * sizeof(uint32_t));
+			std::vector<uint8_t> chunkData(chunkDataSize);
+			decompressData(compressedData.data(), compressedData.size(), chunkData.data(), chunkData.size());
+			if (!chunk->deserialize(chunkData.data(), chunkData.size())) {
+				printf("Received corrupted chunk data.\n");
+				auto chunkOffset = getChunkOffset(key);
+				fillChunk(chunk, chunkOffset[0], chunkOffset[1], seed);
+			}
 		}
 		else if (responseCode == (uint8_t)ResponseCodes::ChunkIsUnchanged) {
 			auto chunkOffset = getChunkOffset(key);
@@ -176,10 +201,9 @@ namespace yamc
 	{
 	}
 
-	void MultiPlayerGame::loadSurroundingChunks(const glm::vec3& playerPosition)
+	int MultiPlayerGame::getSeed() const
 	{
-		std::lock_guard<std::mutex> guard(connectionMutex);
-		Game::loadSurroundingChunks(playerPosition);
+		return seed;
 	}
 
 	bool MultiPlayerGame::sendPackage(PackageBuffer& packageBuffer)
@@ -10,12 +10,15 @@ namespace yamc
 {
 	class MultiPlayerGame : public Game
 	{
+	private:
+		static constexpr float BlockSyncIntervalMilliseconds = 50.0f;
+
 	public:
 		MultiPlayerGame(const std::string& serverAddressStr, int port, uint32_t visibleChunksRadius);
 		virtual void init() override;
 		virtual void update(const glm::vec3& playerPosition, float dt) override;
 		virtual void destroy() override;
-		virtual void loadSurroundingChunks(const glm::vec3& playerPosition) override;
+		virtual int getSeed() const override;
 
 	protected:
 		virtual Chunk* loadChunk(uint64_t key) override;
@@ -32,8 +35,11 @@ namespace yamc
 		PackageBuffer packageBuffer;
 		std::queue<BlockDiff> blockDiffsToSend;
 		std::mutex blockDiffsToSendMutex;
+		std::vector<BlockDiff> receivedBlockDiffs;
+		std::mutex receivedBlockDiffsMutex;
 		std::mutex connectionMutex;
 		
+		void connectToServer();
 		bool requestConnection();
 		void updateBlockDiffs();
 		bool receivePackage(PackageBuffer& packageBuffer);
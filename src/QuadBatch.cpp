@@ -0,0 +1,90 @@
+#include "QuadBatch.h"
+#include <gl3w.h>
+#include <algorithm>
+
+namespace yamc
+{
+	QuadBatch::QuadBatch()
+	{
+		glGenVertexArrays(1, &vaoID);
+		glGenBuffers(1, &vertexBufferID);
+		glGenBuffers(1, &indexBufferID);
+
+		std::vector<uint32_t> indices;
+		indices.reserve(MaxQuads * 6);
+		for (uint32_t i = 0; i < MaxQuads * 4; i += 4) {
+			indices.push_back(i + 0);
+			indices.push_back(i + 2);
+			indices.push_back(i + 1);
+			indices.push_back(i + 0);
+			indices.push_back(i + 3);
+			indices.push_back(i + 2);
+		}
+
+		glBindVertexArray(vaoID);
+
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBufferID);
+		glBufferData(GL_ARRAY_BUFFER, MaxQuads * 4 * sizeof(QuadVertex), nullptr, GL_STREAM_DRAW);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(QuadVertex), (void*)offsetof(QuadVertex, position));
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(QuadVertex), (void*)offsetof(QuadVertex, uv));
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(QuadVertex), (void*)offsetof(QuadVertex, color));
+		glEnableVertexAttribArray(0);
+		glEnableVertexAttribArray(1);
+		glEnableVertexAttribArray(2);
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+
+		glBindVertexArray(0);
+	}
+
+	QuadBatch::QuadBatch(QuadBatch&& other) noexcept
+	{
+		vaoID = other.vaoID;
+		vertexBufferID = other.vertexBufferID;
+		indexBufferID = other.indexBufferID;
+		other.vaoID = 0;
+		other.vertexBufferID = 0;
+		other.indexBufferID = 0;
+	}
+
+	void QuadBatch::addQuad(std::vector<QuadVertex>& vertices, const glm::vec2& position, const glm::vec2& size, const glm::vec2& uvOffset, const glm::vec2& uvSize, const glm::vec4& color)
+	{
+		vertices.push_back({ glm::vec3(position.x, position.y, 0), uvOffset, color });
+		vertices.push_back({ glm::vec3(position.x, position.y + size.y, 0), glm::vec2(uvOffset.x, uvOffset.y + uvSize.y), color });
+		vertices.push_back({ glm::vec3(position.x + size.x, position.y + size.y, 0), uvOffset + uvSize, color });
+		vertices.push_back({ glm::vec3(position.x + size.x, position.y, 0), glm::vec2(uvOffset.x + uvSize.x, uvOffset.y), color });
+	}
+
+	void QuadBatch::draw(const QuadVertex* vertices, size_t count) const
+	{
+		glBindVertexArray(vaoID);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBufferID);
+
+		for (size_t first = 0; first < count; first += MaxQuads * 4) {
+			size_t batchCount = (std::min)(count - first, (size_t)MaxQuads * 4);
+
+			glBufferData(GL_ARRAY_BUFFER, MaxQuads * 4 * sizeof(QuadVertex), nullptr, GL_STREAM_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, batchCount * sizeof(QuadVertex), vertices + first);
+			glDrawElements(GL_TRIANGLES, batchCount / 4 * 6, GL_UNSIGNED_INT, 0);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+	QuadBatch::~QuadBatch()
+	{
+		if (vaoID > 0) {
+			glDeleteVertexArrays(1, &vaoID);
+		}
+
+		if (vertexBufferID > 0) {
+			glDeleteBuffers(1, &vertexBufferID);
+		}
+
+		if (indexBufferID > 0) {
+			glDeleteBuffers(1, &indexBufferID);
+		}
+	}
+}
\ No newline at end of file
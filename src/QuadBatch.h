@@ -0,0 +1,38 @@
+#ifndef YAMC_QUAD_BATCH_H
+#define YAMC_QUAD_BATCH_H
+
+#include <stdint.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace yamc
+{
+	struct QuadVertex
+	{
+		glm::vec3 position;
+		glm::vec2 uv;
+		glm::vec4 color;
+	};
+
+	class QuadBatch
+	{
+	public:
+		static constexpr uint32_t MaxQuads = 4096;
+
+		QuadBatch();
+		QuadBatch(const QuadBatch&) = delete;
+		QuadBatch(QuadBatch&& other) noexcept;
+
+		static void addQuad(std::vector<QuadVertex>& vertices, const glm::vec2& position, const glm::vec2& size, const glm::vec2& uvOffset, const glm::vec2& uvSize, const glm::vec4& color);
+		void draw(const QuadVertex* vertices, size_t count) const;
+
+		~QuadBatch();
+
+	private:
+		uint32_t vaoID;
+		uint32_t vertexBufferID;
+		uint32_t indexBufferID;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "RenderStateCache.h"
+#include <gl3w.h>
+
+namespace yamc
+{
+	RenderStateCache::RenderStateCache() :
+		programID(Unknown),
+		textureID(Unknown),
+		skippedChangeCount(0)
+	{
+	}
+
+	void RenderStateCache::useShader(const Shader& shader)
+	{
+		if (programID == shader.getID()) {
+			skippedChangeCount++;
+			return;
+		}
+
+		shader.use();
+		programID = shader.getID();
+	}
+
+	void RenderStateCache::bindTexture(uint32_t id)
+	{
+		if (textureID == id) {
+			skippedChangeCount++;
+			return;
+		}
+
+		glBindTexture(GL_TEXTURE_2D, id);
+		textureID = id;
+	}
+
+	void RenderStateCache::invalidate()
+	{
+		programID = Unknown;
+		textureID = Unknown;
+		skippedChangeCount = 0;
+	}
+
+	uint32_t RenderStateCache::getSkippedChangeCount() const
+	{
+		return skippedChangeCount;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef YAMC_RENDER_STATE_CACHE_H
+#define YAMC_RENDER_STATE_CACHE_H
+
+#include "Shader.h"
+#include <stdint.h>
+
+namespace yamc
+{
+	class RenderStateCache
+	{
+	public:
+		RenderStateCache();
+
+		void useShader(const Shader& shader);
+		void bindTexture(uint32_t textureID);
+		void invalidate();
+
+		uint32_t getSkippedChangeCount() const;
+
+	private:
+		static constexpr uint32_t Unknown = UINT32_MAX;
+
+		uint32_t programID;
+		uint32_t textureID;
+		uint32_t skippedChangeCount;
+	};
+}
+
+#endif
\ No newline at end of file
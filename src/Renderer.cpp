@@ -1,52 +1,43 @@
 #include "Renderer.h"
+#include "Visibility.h"
 
 #include <vector>
+#include <algorithm>
 #include <glm/gtc/type_ptr.hpp>
 #include "gl3w.h"
 
 namespace yamc
 {
+	const float Renderer::BlockIconFaceIlluminance[6] = { 1.0f, 0.1f, 0.5f, 0.8f, 0.7f, 0.4f };
+	const int Renderer::BlockIconFaces[3] = { 0, 3, 4 };
+
 	Renderer::Renderer() :
 		fontTexture(FontBitmapPath, FontCharactersPerRow, FontRowCount),
 		atlasTexture(AtlasPath, AtlasTilesPerRow, AtlasRowCount),
 		uiShader(UIVertexShaderPath, UIFragmentShaderPath),
 		colorShader(ColorVertexShaderPath, ColorFragmentShaderPath),
 		defaultShader(DefaultVertexShaderPath, DefaultFragmentShaderPath),
+		horizonShader(HorizonVertexShaderPath, HorizonFragmentShaderPath),
 		meshBuilder(atlasTexture)
 	{
-		initQuadMesh();
 		initOutlineMesh();
-		initBlockMesh();
+		initBlockIconVertices();
 	}
 
-	void Renderer::renderText(const glm::mat4& projectionMatrix, const std::string& text, const glm::vec3& color, const glm::vec2& offset, uint32_t scale) const
+	void Renderer::renderText(const std::string& text, const glm::vec3& color, const glm::vec2& offset, uint32_t scale) const
 	{
-		auto scaleMatrix = glm::scale(glm::mat4(1), glm::vec3(scale * fontTexture.getTileWidth(), scale * fontTexture.getTileHeight(), 1));
-		glm::vec3 characterOffsetVector(offset.x, offset.y, 0);
-	
-		uiShader.use();
-
-		glBindTexture(GL_TEXTURE_2D, fontTexture.getID());
-		glBindVertexArray(quadMesh.getVAO());
+		glm::vec2 glyphSize(scale * fontTexture.getTileWidth(), scale * fontTexture.getTileHeight());
+		glm::vec2 glyphOffset = offset;
 
 		for (int i = 0; i < text.length(); i++) {
-			characterOffsetVector.x += (FontCharacterOffset + fontTexture.getTileWidth()) * scale;
-			auto offsetMatrix = glm::translate(glm::mat4(1), characterOffsetVector);
-
-			uiShader.setMVP(projectionMatrix * offsetMatrix * scaleMatrix);
-			uiShader.setTextureOffset(fontTexture.getTileOffset(text[i]));
-			uiShader.setColor(color);
-			uiShader.setTextureScale(fontTexture.getUVScale());
-			glDrawElements(GL_TRIANGLES, quadMesh.getIndicesCount(), GL_UNSIGNED_INT, 0);
+			glyphOffset.x += (FontCharacterOffset + fontTexture.getTileWidth()) * scale;
+			spriteBatch.addQuad(UITextLayer, fontTexture.getID(), glyphOffset, glyphSize, fontTexture.getTileOffset(text[i]), fontTexture.getUVScale(), glm::vec4(color, 1));
 		}
-		
-		glBindVertexArray(0);
-		glUseProgram(0);
 	}
 
 	void Renderer::renderCubeOutline(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix, const glm::vec3& center) const
 	{
-		glUseProgram(colorShader.getID());
+		renderState.useShader(colorShader);
 
 		auto modelMatrix = glm::translate(glm::identity<glm::mat4>(), center);
 		glm::vec4 outlineColor(0.6f, 0.6f, 0.6f, 1.0f);
@@ -57,13 +48,11 @@ namespace yamc
 		glBindVertexArray(outlineMesh.getVAO());
 		glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, 0);
 		glBindVertexArray(0);
-
-		glUseProgram(0);
 	}
 
 	void Renderer::renderCross(const glm::mat4& projectionMatrix, const glm::vec2& center) const
 	{
-		glUseProgram(colorShader.getID());
+		renderState.useShader(colorShader);
 
 		auto modelMatrix = glm::translate(glm::identity<glm::mat4>(), glm::vec3(center.x, center.y, 0));
 		auto mvp = projectionMatrix * modelMatrix * glm::scale(glm::identity<glm::mat4>(), glm::vec3(26, 26, 26));
@@ -75,44 +64,170 @@ namespace yamc
 		glBindVertexArray(outlineMesh.getVAO());
 		glDrawElements(GL_LINES, 4, GL_UNSIGNED_INT, (void*)(24 * sizeof(uint32_t)));
 		glBindVertexArray(0);
+	}
 
-		glUseProgram(0);
+	void Renderer::renderHorizon(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix, const Mesh& horizonMesh, const glm::vec3& cameraPosition, const glm::vec3& fogColor, const glm::vec2& fogRange) const
+	{
+		if (horizonMesh.getIndicesCount() == 0) {
+			return;
+		}
+
+		renderState.useShader(horizonShader);
+		horizonShader.setMVP(projectionMatrix * viewMatrix);
+		horizonShader.setCameraPosition(cameraPosition);
+		horizonShader.setColor(fogColor);
+		horizonShader.setFogRange(fogRange);
+
+		glBindVertexArray(horizonMesh.getVAO());
+		glDrawElements(GL_TRIANGLES, horizonMesh.getIndicesCount(), GL_UNSIGNED_INT, 0);
+		glBindVertexArray(0);
 	}
 
-	void Renderer::renderTerrain(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix, const std::unordered_map<uint64_t, Mesh*>& chunkMeshes, int visibleChunksRadius, const glm::vec3 cameraPosition) const
+	TerrainRenderStats Renderer::renderTerrain(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix, const ChunkBufferArena& chunkBufferArena, const std::unordered_map<uint64_t, ChunkMesh*>& chunkMeshes, int visibleChunksRadius, const glm::vec3 cameraPosition) const
 	{
-		defaultShader.use();
-		glBindTexture(GL_TEXTURE_2D, atlasTexture.getID());
+		TerrainRenderStats stats = {};
+		Frustum frustum(projectionMatrix * viewMatrix);
+
+		renderState.useShader(defaultShader);
+		renderState.bindTexture(atlasTexture.getID());
 
 		defaultShader.setTextureOffset(glm::vec2(0, 0));
+		defaultShader.setTextureScale(atlasTexture.getUVScale());
+		defaultShader.setChunkOffsetsTextureUnit(1);
+		defaultShader.setMVP(projectionMatrix * viewMatrix);
 
 		int cameraChunkX = getChunkIndex(cameraPosition.x, Chunk::MaxWidth);
 		int cameraChunkZ = getChunkIndex(cameraPosition.z, Chunk::MaxLength);
+		int cameraSectionY = (int)floorf(cameraPosition.y / Chunk::SectionHeight);
 
+		visibilityGrid.reset(cameraChunkX - visibleChunksRadius, cameraChunkZ - visibleChunksRadius, visibleChunksRadius * 2 + 1);
 		for (int x = cameraChunkX - visibleChunksRadius; x <= cameraChunkX + visibleChunksRadius; x++) {
 			for (int z = cameraChunkZ - visibleChunksRadius; z <= cameraChunkZ + visibleChunksRadius; z++) {
-				uint64_t key = getChunkKey(x, z);
-				auto pair = chunkMeshes.find(key);
-				if (pair != chunkMeshes.end()) {
-					glm::vec3 offset(x * (float)Chunk::MaxWidth, 0, z * (float)Chunk::MaxLength);
-
-					auto mesh = pair->second;
-					if (mesh->getIndicesCount() > 0) {
-						auto modelMatrix = glm::translate(glm::identity<glm::mat4>(), offset);
-						defaultShader.setMVP(projectionMatrix * viewMatrix * modelMatrix);
-
-						glBindVertexArray(mesh->getVAO());
-						glDrawElements(GL_TRIANGLES, mesh->getIndicesCount(), GL_UNSIGNED_INT, 0);
-						glBindVertexArray(0);
-					}
+				auto pair = chunkMeshes.find(getChunkKey(x, z));
+				if (pair == chunkMeshes.end()) {
+					continue;
+				}
+
+				for (uint32_t i = 0; i < Chunk::SectionCount; i++) {
+					visibilityGrid.setConnectivity(x, z, i, pair->second->sectionConnectivity[i]);
+				}
+			}
+		}
+		visibilityGrid.findVisibleSections(glm::ivec3(cameraChunkX, cameraSectionY, cameraChunkZ), frustum);
+
+		std::vector<int32_t> drawCounts;
+		std::vector<const void*> drawOffsets;
+		std::vector<int32_t> drawBaseVertices;
+
+		bool isDescending = cameraSectionY >= (int)Chunk::SectionCount / 2;
+
+		for (auto& chunkOffset : getChunkDrawOrder(visibleChunksRadius)) {
+			int x = cameraChunkX + chunkOffset.x;
+			int z = cameraChunkZ + chunkOffset.y;
+			uint64_t key = getChunkKey(x, z);
+			auto pair = chunkMeshes.find(key);
+			if (pair == chunkMeshes.end() || pair->second->allocation.indexCount == 0) {
+				continue;
+			}
+
+			glm::vec3 offset(x * (float)Chunk::MaxWidth, 0, z * (float)Chunk::MaxLength);
+			glm::vec3 chunkSize(Chunk::MaxWidth, Chunk::MaxHeight, Chunk::MaxLength);
+
+			stats.chunksTested++;
+			if (!frustum.intersectsBox(offset, offset + chunkSize)) {
+				stats.chunksCulled++;
+				continue;
+			}
+			stats.chunksDrawn++;
+
+			auto chunkMesh = pair->second;
+			const ChunkAllocation& allocation = chunkMesh->allocation;
+
+			IndexRange batch = { 0, 0 };
+			for (int n = 0; n < (int)Chunk::SectionCount; n++) {
+				int i = isDescending ? (int)Chunk::SectionCount - 1 - n : n;
+				const IndexRange& section = chunkMesh->sections[i];
+				if (section.count == 0) {
+					continue;
 				}
+
+				glm::vec3 sectionMin = offset + glm::vec3(0, i * Chunk::SectionHeight, 0);
+				glm::vec3 sectionMax = sectionMin + glm::vec3(Chunk::MaxWidth, Chunk::SectionHeight, Chunk::MaxLength);
+
+				stats.sectionsTested++;
+				if (!frustum.intersectsBox(sectionMin, sectionMax)) {
+					stats.sectionsCulled++;
+					continue;
+				}
+
+				if (!visibilityGrid.isSectionVisible(x, z, i)) {
+					stats.sectionsOccluded++;
+					continue;
+				}
+				stats.sectionsDrawn++;
+
+				bool isAdjacent = batch.offset + batch.count == section.offset || section.offset + section.count == batch.offset;
+				if (batch.count > 0 && !isAdjacent) {
+					drawCounts.push_back(batch.count);
+					drawOffsets.push_back((void*)((allocation.indexOffset + batch.offset) * sizeof(uint32_t)));
+					drawBaseVertices.push_back(allocation.vertexOffset);
+					batch.count = 0;
+				}
+
+				batch.offset = batch.count == 0 ? section.offset : (std::min)(batch.offset, section.offset);
+				batch.count += section.count;
+			}
+
+			if (batch.count > 0) {
+				drawCounts.push_back(batch.count);
+				drawOffsets.push_back((void*)((allocation.indexOffset + batch.offset) * sizeof(uint32_t)));
+				drawBaseVertices.push_back(allocation.vertexOffset);
 			}
 		}
 
-		glUseProgram(0);
+		if (!drawCounts.empty()) {
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_BUFFER, chunkBufferArena.getChunkOffsetsTextureID());
+			glActiveTexture(GL_TEXTURE0);
+
+			glBindVertexArray(chunkBufferArena.getVAO());
+			glMultiDrawElementsBaseVertex(GL_TRIANGLES, drawCounts.data(), GL_UNSIGNED_INT, drawOffsets.data(), drawCounts.size(), drawBaseVertices.data());
+			glBindVertexArray(0);
+
+			stats.drawCalls++;
+			stats.drawRanges = drawCounts.size();
+		}
+
+		return stats;
 	}
 
-	void Renderer::renderInventoryHotbar(const glm::mat4& projectionMatrix, const glm::vec2& center, const Inventory& inventory) const
+	const std::vector<glm::ivec2>& Renderer::getChunkDrawOrder(int visibleChunksRadius) const
+	{
+		size_t sideLength = visibleChunksRadius * 2 + 1;
+		if (chunkDrawOrder.size() == sideLength * sideLength) {
+			return chunkDrawOrder;
+		}
+
+		chunkDrawOrder.clear();
+		for (int x = -visibleChunksRadius; x <= visibleChunksRadius; x++) {
+			for (int z = -visibleChunksRadius; z <= visibleChunksRadius; z++) {
+				chunkDrawOrder.push_back(glm::ivec2(x, z));
+			}
+		}
+
+		std::stable_sort(chunkDrawOrder.begin(), chunkDrawOrder.end(), [](const glm::ivec2& a, const glm::ivec2& b) {
+			return a.x * a.x + a.y * a.y < b.x * b.x + b.y * b.y;
+		});
+
+		return chunkDrawOrder;
+	}
+
+	void Renderer::beginFrame() const
+	{
+		renderState.invalidate();
+	}
+
+	void Renderer::renderInventoryHotbar(const glm::vec2& center, const Inventory& inventory) const
 	{
 		uint32_t scale = 4;
 		float hotbarWidth = atlasTexture.getTileWidth() * inventory.MaxHotbarItems * scale;
@@ -120,90 +235,62 @@ namespace yamc
 
 		glm::vec2 offset = { center.x - hotbarWidth / 2, center.y - hotbarHeight / 2 };
 
-		renderColoredQuad(projectionMatrix, { 0.0, 0.0, 0.0, 0.5 }, offset, glm::vec2(hotbarWidth, hotbarHeight));
+		renderColoredQuad({ 0.0, 0.0, 0.0, 0.5 }, offset, glm::vec2(hotbarWidth, hotbarHeight));
 
 		for (int i = 0; i < Inventory::MaxHotbarItems; i++) {
 			auto color = i == inventory.getSelectedHotbarSlot() ? glm::vec3(1, 1, 1) : glm::vec3(0.7, 0.7, 0.7);
-			renderTile(projectionMatrix, 1023, color, offset, scale);
+			renderTile(1023, color, offset, scale);
 
 			auto item = inventory.getHotbarItem(i);
 			if (item) {
 				glm::vec2 blockIconCenter(offset.x + atlasTexture.getTileWidth() * scale / 2, offset.y + atlasTexture.getTileHeight() * scale / 2);
-				renderBlockIcon(projectionMatrix, item->id, blockIconCenter, scale);
+				renderBlockIcon(item->id, blockIconCenter, scale);
 			}
 
 			offset.x += atlasTexture.getTileWidth() * scale;
 		}
 	}
 
-	void Renderer::renderTile(const glm::mat4& projectionMatrix, uint32_t id, const glm::vec3& color, const glm::vec2& offset, uint32_t scale) const
+	void Renderer::renderTile(uint32_t id, const glm::vec3& color, const glm::vec2& offset, uint32_t scale) const
 	{
-		auto scaleMatrix = glm::scale(glm::mat4(1), glm::vec3(scale * atlasTexture.getTileWidth(), scale * atlasTexture.getTileHeight(), scale));
-		glm::vec3 offsetVector(offset.x, offset.y, 0);
-
-		uiShader.use();
-
-		glBindTexture(GL_TEXTURE_2D, atlasTexture.getID());
-		glBindVertexArray(quadMesh.getVAO());
-
-		auto textureOffset = atlasTexture.getTileOffset(id);
-		auto offsetMatrix = glm::translate(glm::mat4(1), offsetVector);
-
-		uiShader.setMVP(projectionMatrix * offsetMatrix * scaleMatrix);
-		uiShader.setTextureOffset(textureOffset);
-		uiShader.setColor(color);
-		uiShader.setTextureScale(atlasTexture.getUVScale());
-		glDrawElements(GL_TRIANGLES, quadMesh.getIndicesCount(), GL_UNSIGNED_INT, 0);
-
-		glBindVertexArray(0);
-		glUseProgram(0);
+		glm::vec2 size(scale * atlasTexture.getTileWidth(), scale * atlasTexture.getTileHeight());
+		spriteBatch.addQuad(UITileLayer, atlasTexture.getID(), offset, size, atlasTexture.getTileOffset(id), atlasTexture.getUVScale(), glm::vec4(color, 1));
 	}
 
-	void Renderer::renderColoredQuad(const glm::mat4& projectionMatrix, const glm::vec4& color, const glm::vec2& offset, const glm::vec2& size) const
+	void Renderer::renderColoredQuad(const glm::vec4& color, const glm::vec2& offset, const glm::vec2& size) const
 	{
-		glm::vec3 offsetVector(offset.x, offset.y, 0);
-		auto scaleMatrix = glm::scale(glm::mat4(1), glm::vec3(size.x, size.y, 1));
-
-		colorShader.use();
-
-		glBindVertexArray(quadMesh.getVAO());
-
-		auto offsetMatrix = glm::translate(glm::mat4(1), offsetVector);
-		auto mvp = projectionMatrix * offsetMatrix * scaleMatrix;
-
-		colorShader.setMVP(mvp);
-		colorShader.setColor(color);
-		glDrawElements(GL_TRIANGLES, quadMesh.getIndicesCount(), GL_UNSIGNED_INT, 0);
-
-		glBindVertexArray(0);
-		glUseProgram(0);
+		spriteBatch.addQuad(UIBackgroundLayer, SpriteBatch::NoTexture, offset, size, glm::vec2(-1, -1), glm::vec2(0, 0), color);
 	}
 
-	void Renderer::renderBlockIcon(const glm::mat4& projectionMatrix, uint32_t id, const glm::vec2& center, uint32_t scale) const
+	void Renderer::renderBlockIcon(uint32_t id, const glm::vec2& center, uint32_t scale) const
 	{
 		glm::vec3 scaleVector (scale * 6, scale * 6, scale * 6);
 		scaleVector.y *= -1;
 		auto offsetMatrix = glm::translate(glm::mat4(1), glm::vec3(center.x, center.y, 0));
 		auto rotationMatrix = glm::rotate(glm::mat4(1), glm::radians(45.0f), glm::vec3(1, 0, 0)) * glm::rotate(glm::mat4(1), glm::radians(45.0f), glm::vec3(0, 1, 0));
 		auto scaleMatrix = glm::scale(glm::mat4(1), scaleVector);
+		auto centerMatrix = glm::translate(glm::mat4(1), glm::vec3(-0.5f, -0.5f, -0.5f));
+		auto modelMatrix = offsetMatrix * rotationMatrix * scaleMatrix * centerMatrix;
 		auto atlasIndices = MeshBuilder::BlockAtlasIndicesByType[id];
 
-		defaultShader.use();
+		for (int face : BlockIconFaces) {
+			auto textureOffset = atlasTexture.getTileOffset(atlasIndices[face == 0 ? 0 : 2]);
 
-		defaultShader.setMVP(projectionMatrix * offsetMatrix * rotationMatrix * scaleMatrix);
-		glBindTexture(GL_TEXTURE_2D, atlasTexture.getID());
-		glBindVertexArray(blockMesh.getVAO());
-
-		//top
-		defaultShader.setTextureOffset(atlasTexture.getTileOffset(atlasIndices[0]));
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+			QuadVertex quad[4];
+			for (int i = 0; i < 4; i++) {
+				const QuadVertex& vertex = blockIconVertices[face * 4 + i];
+				quad[i].position = glm::vec3(modelMatrix * glm::vec4(vertex.position, 1));
+				quad[i].uv = textureOffset + vertex.uv * atlasTexture.getUVScale();
+				quad[i].color = vertex.color;
+			}
 
-		//sides
-		defaultShader.setTextureOffset(atlasTexture.getTileOffset(atlasIndices[2]));
-		glDrawElements(GL_TRIANGLES, 12, GL_UNSIGNED_INT, (void*)(18 * sizeof(uint32_t)));
+			spriteBatch.addQuad(UIIconLayer, atlasTexture.getID(), quad);
+		}
+	}
 
-		glBindVertexArray(0);
-		glUseProgram(0);
+	void Renderer::flushUI(const glm::mat4& projectionMatrix) const
+	{
+		spriteBatch.flush(renderState, uiShader, projectionMatrix);
 	}
 
 	const MeshBuilder& Renderer::getMeshBuilder() const
@@ -211,27 +298,9 @@ namespace yamc
 		return meshBuilder;
 	}
 
-	void Renderer::initQuadMesh()
+	uint32_t Renderer::getSkippedStateChangeCount() const
 	{
-		std::vector<glm::vec3> positions = {
-			{0, 0, 0},
-			{0, 1, 0},
-			{1, 1, 0},
-			{1, 0, 0}
-		};
-
-		std::vector<glm::vec2> uvs = {
-			{0, 0},
-			{0, 1},
-			{1, 1},
-			{1, 0},
-		};
-
-		std::vector<uint32_t> indices = {
-			0, 2, 1, 0, 3, 2
-		};
-
-		quadMesh.setData(positions, uvs, indices);
+		return renderState.getSkippedChangeCount();
 	}
 
 	void Renderer::initOutlineMesh()
@@ -270,15 +339,19 @@ namespace yamc
 		outlineMesh.setData(outlinePositions, outlineIndices);
 	}
 
-	void Renderer::initBlockMesh()
+	void Renderer::initBlockIconVertices()
 	{
-		std::vector<glm::vec4> positions;
-		std::vector<glm::vec2> uvs;
+		std::vector<glm::uvec2> vertices;
 		std::vector<uint32_t> indices;
 
-		meshBuilder.addCubeBlock(positions, uvs, indices, { 0, 0, 0 }, {0, 0, 0}, 0);
+		meshBuilder.addCubeBlock(vertices, indices, { 0, 0, 0 }, 0);
 
-		blockMesh.setData(positions, uvs, indices);
+		for (auto& vertex : vertices) {
+			glm::vec3 position(vertex.x & 31, (vertex.x >> 5) & 255, (vertex.x >> 13) & 31);
+			glm::vec2 uv((vertex.y >> 16) & 31, (vertex.y >> 21) & 31);
+			float illuminance = BlockIconFaceIlluminance[(vertex.x >> 18) & 7];
+			blockIconVertices.push_back({ position, uv, glm::vec4(illuminance, illuminance, illuminance, 1) });
+		}
 	}
 
 	Renderer::~Renderer()
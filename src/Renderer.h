@@ -6,10 +6,27 @@
 #include "Mesh.h"
 #include "Inventory.h"
 #include "MeshBuilder.h"
+#include "Frustum.h"
+#include "SpriteBatch.h"
+#include "Visibility.h"
 #include <glm/glm.hpp>
+#include <unordered_map>
 
 namespace yamc
 {
+	struct TerrainRenderStats
+	{
+		uint32_t chunksTested;
+		uint32_t chunksCulled;
+		uint32_t chunksDrawn;
+		uint32_t sectionsTested;
+		uint32_t sectionsCulled;
+		uint32_t sectionsOccluded;
+		uint32_t sectionsDrawn;
+		uint32_t drawCalls;
+		uint32_t drawRanges;
+	};
+
 	class Renderer
 	{
 	private:
@@ -32,38 +49,58 @@ namespace yamc
 		static constexpr char* DefaultVertexShaderPath = "data/shaders/default.vert";
 		static constexpr char* DefaultFragmentShaderPath = "data/shaders/default.frag";
 
+		static constexpr char* HorizonVertexShaderPath = "data/shaders/horizon.vert";
+		static constexpr char* HorizonFragmentShaderPath = "data/shaders/horizon.frag";
+
+		static constexpr uint32_t UIBackgroundLayer = 0;
+		static constexpr uint32_t UITileLayer = 1;
+		static constexpr uint32_t UIIconLayer = 2;
+		static constexpr uint32_t UITextLayer = 3;
+
+		static const float BlockIconFaceIlluminance[6];
+		static const int BlockIconFaces[3];
+
 	public:
 		Renderer();
 		Renderer(Renderer&&) = default;
 		Renderer(const Renderer&) = delete;
-		void renderText(const glm::mat4& projectionMatrix, const std::string& text, const glm::vec3& color, const glm::vec2& offset, uint32_t scale) const;
+		void renderText(const std::string& text, const glm::vec3& color, const glm::vec2& offset, uint32_t scale) const;
 		void renderCubeOutline(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix, const glm::vec3& center) const;
 		void renderCross(const glm::mat4& projectionMatrix, const glm::vec2& center) const;
-		void renderTerrain(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix, const std::unordered_map<uint64_t, Mesh*>& chunkMeshes, int visibleChunksRadius, const glm::vec3 cameraPosition) const;
-		void renderInventoryHotbar(const glm::mat4& projectionMatrix, const glm::vec2& center, const Inventory& inventory) const;
-		void renderTile(const glm::mat4& projectionMatrix, uint32_t id, const glm::vec3& color, const glm::vec2& offset, uint32_t scale) const;
-		void renderColoredQuad(const glm::mat4& projectionMatrix, const glm::vec4& color, const glm::vec2& offset, const glm::vec2& size) const;
-		void renderBlockIcon(const glm::mat4& projectionMatrix, uint32_t id, const glm::vec2& center, uint32_t scale) const;
+		TerrainRenderStats renderTerrain(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix, const ChunkBufferArena& chunkBufferArena, const std::unordered_map<uint64_t, ChunkMesh*>& chunkMeshes, int visibleChunksRadius, const glm::vec3 cameraPosition) const;
+		void renderHorizon(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix, const Mesh& horizonMesh, const glm::vec3& cameraPosition, const glm::vec3& fogColor, const glm::vec2& fogRange) const;
+		void renderInventoryHotbar(const glm::vec2& center, const Inventory& inventory) const;
+		void renderTile(uint32_t id, const glm::vec3& color, const glm::vec2& offset, uint32_t scale) const;
+		void renderColoredQuad(const glm::vec4& color, const glm::vec2& offset, const glm::vec2& size) const;
+		void renderBlockIcon(uint32_t id, const glm::vec2& center, uint32_t scale) const;
+		void flushUI(const glm::mat4& projectionMatrix) const;
+		void beginFrame() const;
 		const MeshBuilder& getMeshBuilder() const;
+		uint32_t getSkippedStateChangeCount() const;
 		~Renderer();
 
 	private:
 		Shader uiShader;
 		Shader colorShader;
 		Shader defaultShader;
+		Shader horizonShader;
 
 		AtlasTexture fontTexture;
 		AtlasTexture atlasTexture;
 		
-		Mesh quadMesh;
 		Mesh outlineMesh;
-		Mesh blockMesh;
+
+		mutable SpriteBatch spriteBatch;
+		mutable RenderStateCache renderState;
+		mutable std::vector<glm::ivec2> chunkDrawOrder;
+		mutable SectionVisibilityGrid visibilityGrid;
+		std::vector<QuadVertex> blockIconVertices;
 
 		MeshBuilder meshBuilder;
 
-		void initQuadMesh();
 		void initOutlineMesh();
-		void initBlockMesh();
+		void initBlockIconVertices();
+		const std::vector<glm::ivec2>& getChunkDrawOrder(int visibleChunksRadius) const;
 	};
 }
 
@@ -49,6 +49,7 @@ namespace yamc
 
         glBindAttribLocation(id, 0, "position");
         glBindAttribLocation(id, 1, "in_uv");
+        glBindAttribLocation(id, 2, "in_color");
         
 		glLinkProgram(id);
 
@@ -69,7 +70,10 @@ namespace yamc
 		mvpUniformLocation(0),
 		textureOffsetUniformLocation(0),
 		textureScaleUniformLocation(0),
-		colorUniformLocation(0)
+		colorUniformLocation(0),
+		chunkOffsetsUniformLocation(0),
+		cameraPositionUniformLocation(0),
+		fogRangeUniformLocation(0)
 	{
 		uint32_t vertexShaderID = compileShader(vertexShaderPath, GL_VERTEX_SHADER);
 		uint32_t fragmentShaderID = compileShader(fragmentShaderPath, GL_FRAGMENT_SHADER);
@@ -86,7 +90,10 @@ namespace yamc
 		mvpUniformLocation(other.mvpUniformLocation),
 		textureOffsetUniformLocation(other.textureOffsetUniformLocation),
 		textureScaleUniformLocation(other.textureScaleUniformLocation),
-		colorUniformLocation(other.colorUniformLocation)
+		colorUniformLocation(other.colorUniformLocation),
+		chunkOffsetsUniformLocation(other.chunkOffsetsUniformLocation),
+		cameraPositionUniformLocation(other.cameraPositionUniformLocation),
+		fogRangeUniformLocation(other.fogRangeUniformLocation)
 	{
 		programID = other.programID;
 		other.programID = 0;
@@ -142,12 +149,39 @@ namespace yamc
 		glUniform2fv(textureScaleUniformLocation, 1, glm::value_ptr(scale));
 	}
 
+	void Shader::setChunkOffsetsTextureUnit(int unit) const
+	{
+		if (chunkOffsetsUniformLocation < 0) {
+			return;
+		}
+		glUniform1i(chunkOffsetsUniformLocation, unit);
+	}
+
+	void Shader::setCameraPosition(const glm::vec3& position) const
+	{
+		if (cameraPositionUniformLocation < 0) {
+			return;
+		}
+		glUniform3fv(cameraPositionUniformLocation, 1, glm::value_ptr(position));
+	}
+
+	void Shader::setFogRange(const glm::vec2& range) const
+	{
+		if (fogRangeUniformLocation < 0) {
+			return;
+		}
+		glUniform2fv(fogRangeUniformLocation, 1, glm::value_ptr(range));
+	}
+
 	void Shader::setupUniformLocations()
 	{
 		mvpUniformLocation = glGetUniformLocation(programID, "mvp");
 		textureOffsetUniformLocation = glGetUniformLocation(programID, "textureOffset");
 		textureScaleUniformLocation = glGetUniformLocation(programID, "textureScale");
 		colorUniformLocation = glGetUniformLocation(programID, "color");
+		chunkOffsetsUniformLocation = glGetUniformLocation(programID, "chunkOffsets");
+		cameraPositionUniformLocation = glGetUniformLocation(programID, "cameraPosition");
+		fogRangeUniformLocation = glGetUniformLocation(programID, "fogRange");
 	}
 
 	Shader::~Shader()
@@ -21,6 +21,9 @@ namespace yamc
 		void setColor(const glm::vec4& color) const;
 		void setTextureOffset(const glm::vec2& offset) const;
 		void setTextureScale(const glm::vec2& scale) const;
+		void setChunkOffsetsTextureUnit(int unit) const;
+		void setCameraPosition(const glm::vec3& position) const;
+		void setFogRange(const glm::vec2& range) const;
 
 		~Shader();
 	private:
@@ -31,6 +34,9 @@ namespace yamc
 		int textureOffsetUniformLocation;
 		int textureScaleUniformLocation;
 		int colorUniformLocation;
+		int chunkOffsetsUniformLocation;
+		int cameraPositionUniformLocation;
+		int fogRangeUniformLocation;
 	};
 }
 
@@ -20,7 +20,9 @@ namespace yamc
 
 	Chunk* SinglePlayerGame::loadChunk(uint64_t key)
 	{
-		return worldDataManager.loadChunk(key);
+		auto chunk = terrain.getChunkPool().acquireChunk();
+		worldDataManager.loadChunk(key, chunk);
+		return chunk;
 	}
 
 	void SinglePlayerGame::saveChunk(uint64_t key, Chunk* chunk)
@@ -32,9 +34,14 @@ namespace yamc
 	{
 		Game::destroy();
 
-		auto chunks = terrain.getChunks();
+		auto& chunks = terrain.getChunks();
 		for (uint64_t key : terrain.getChunkKeysToSave()) {
-			worldDataManager.saveChunk(key, chunks[key]);
+			worldDataManager.saveChunk(key, chunks.get(key));
 		}
 	}
+
+	int SinglePlayerGame::getSeed() const
+	{
+		return worldDataManager.getSeed();
+	}
 }
\ No newline at end of file
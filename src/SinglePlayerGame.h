@@ -12,6 +12,7 @@ namespace yamc
 		virtual void init() override;
 		virtual void update(const glm::vec3& playerPosition, float dt) override;
 		virtual void destroy() override;
+		virtual int getSeed() const override;
 
 	protected:
 		virtual Chunk* loadChunk(uint64_t key) override;
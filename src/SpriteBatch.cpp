@@ -0,0 +1,72 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+
+namespace yamc
+{
+	SpriteBatch::SpriteBatch()
+	{
+		sprites.reserve(QuadBatch::MaxQuads);
+		vertices.reserve(QuadBatch::MaxQuads * 4);
+		sortedVertices.reserve(QuadBatch::MaxQuads * 4);
+	}
+
+	void SpriteBatch::addQuad(uint32_t layer, uint32_t textureID, const glm::vec2& position, const glm::vec2& size, const glm::vec2& uvOffset, const glm::vec2& uvSize, const glm::vec4& color)
+	{
+		sprites.push_back({ layer, textureID, (uint32_t)vertices.size() });
+		QuadBatch::addQuad(vertices, position, size, uvOffset, uvSize, color);
+	}
+
+	void SpriteBatch::addQuad(uint32_t layer, uint32_t textureID, const QuadVertex* quadVertices)
+	{
+		sprites.push_back({ layer, textureID, (uint32_t)vertices.size() });
+		vertices.insert(vertices.end(), quadVertices, quadVertices + 4);
+	}
+
+	uint32_t SpriteBatch::flush(RenderStateCache& renderState, const Shader& shader, const glm::mat4& projectionMatrix)
+	{
+		if (sprites.empty()) {
+			return 0;
+		}
+
+		std::stable_sort(sprites.begin(), sprites.end(), [](const Sprite& a, const Sprite& b) {
+			if (a.layer != b.layer) {
+				return a.layer < b.layer;
+			}
+			return a.textureID < b.textureID;
+		});
+
+		sortedVertices.clear();
+		for (auto& sprite : sprites) {
+			sortedVertices.insert(sortedVertices.end(), &vertices[sprite.firstVertex], &vertices[sprite.firstVertex] + 4);
+		}
+
+		renderState.useShader(shader);
+		shader.setMVP(projectionMatrix);
+
+		uint32_t drawCalls = 0;
+		uint32_t runTextureID = NoTexture;
+		size_t runStart = 0;
+		for (size_t i = 0; i <= sprites.size(); i++) {
+			if (i < sprites.size()) {
+				uint32_t textureID = sprites[i].textureID;
+				if (textureID == NoTexture || runTextureID == NoTexture || textureID == runTextureID) {
+					runTextureID = (std::max)(runTextureID, textureID);
+					continue;
+				}
+			}
+
+			if (runTextureID != NoTexture) {
+				renderState.bindTexture(runTextureID);
+			}
+			quadBatch.draw(&sortedVertices[runStart * 4], (i - runStart) * 4);
+			drawCalls++;
+
+			runStart = i;
+			runTextureID = i < sprites.size() ? sprites[i].textureID : NoTexture;
+		}
+
+		sprites.clear();
+		vertices.clear();
+		return drawCalls;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef YAMC_SPRITE_BATCH_H
+#define YAMC_SPRITE_BATCH_H
+
+#include "QuadBatch.h"
+#include "RenderStateCache.h"
+#include <vector>
+
+namespace yamc
+{
+	class SpriteBatch
+	{
+	public:
+		static constexpr uint32_t NoTexture = 0;
+
+		SpriteBatch();
+		SpriteBatch(const SpriteBatch&) = delete;
+		SpriteBatch(SpriteBatch&&) = default;
+
+		void addQuad(uint32_t layer, uint32_t textureID, const glm::vec2& position, const glm::vec2& size, const glm::vec2& uvOffset, const glm::vec2& uvSize, const glm::vec4& color);
+		void addQuad(uint32_t layer, uint32_t textureID, const QuadVertex* vertices);
+		uint32_t flush(RenderStateCache& renderState, const Shader& shader, const glm::mat4& projectionMatrix);
+
+	private:
+		struct Sprite
+		{
+			uint32_t layer;
+			uint32_t textureID;
+			uint32_t firstVertex;
+		};
+
+		QuadBatch quadBatch;
+		std::vector<Sprite> sprites;
+		std::vector<QuadVertex> vertices;
+		std::vector<QuadVertex> sortedVertices;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "StagingRing.h"
+#include <gl3w.h>
+#include <cstring>
+
+namespace yamc
+{
+	StagingRing::StagingRing(size_t capacity) :
+		capacity(capacity),
+		head(0),
+		unfencedStart(0),
+		stallCount(0)
+	{
+		glGenBuffers(1, &bufferID);
+		glBindBuffer(GL_COPY_READ_BUFFER, bufferID);
+		glBufferData(GL_COPY_READ_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	}
+
+	void StagingRing::retireRegions(size_t start, size_t end)
+	{
+		while (!regions.empty()) {
+			GLsync sync = (GLsync)regions.front().sync;
+			bool isOverlapping = false;
+			for (auto& region : regions) {
+				if (region.start < end && start < region.end) {
+					isOverlapping = true;
+					break;
+				}
+			}
+
+			GLenum status = glClientWaitSync(sync, 0, 0);
+			if (status == GL_TIMEOUT_EXPIRED) {
+				if (!isOverlapping) {
+					return;
+				}
+
+				stallCount++;
+				glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			}
+
+			glDeleteSync(sync);
+			regions.pop_front();
+		}
+	}
+
+	void StagingRing::upload(uint32_t targetBufferID, size_t targetOffset, const void* data, size_t size)
+	{
+		if (size == 0) {
+			return;
+		}
+
+		if (size > capacity) {
+			glBindBuffer(GL_COPY_WRITE_BUFFER, targetBufferID);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, targetOffset, size, data);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+			return;
+		}
+
+		if (head + size > capacity) {
+			fence();
+			head = 0;
+			unfencedStart = 0;
+		}
+
+		retireRegions(head, head + size);
+
+		glBindBuffer(GL_COPY_READ_BUFFER, bufferID);
+		void* mapping = glMapBufferRange(GL_COPY_READ_BUFFER, head, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+		memcpy(mapping, data, size);
+		glUnmapBuffer(GL_COPY_READ_BUFFER);
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, targetBufferID);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, head, targetOffset, size);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+		head = (head + size + Alignment - 1) / Alignment * Alignment;
+	}
+
+	void StagingRing::fence()
+	{
+		if (head == unfencedStart) {
+			return;
+		}
+
+		Region region;
+		region.start = unfencedStart;
+		region.end = head;
+		region.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		regions.push_back(region);
+
+		unfencedStart = head;
+	}
+
+	uint32_t StagingRing::getStallCount() const
+	{
+		return stallCount;
+	}
+
+	StagingRing::~StagingRing()
+	{
+		for (auto& region : regions) {
+			glDeleteSync((GLsync)region.sync);
+		}
+		glDeleteBuffers(1, &bufferID);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef YAMC_STAGING_RING_H
+#define YAMC_STAGING_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <deque>
+
+namespace yamc
+{
+	class StagingRing
+	{
+	public:
+		static constexpr size_t DefaultCapacity = 8 * 1024 * 1024;
+		static constexpr size_t Alignment = 64;
+
+		StagingRing(size_t capacity = DefaultCapacity);
+		StagingRing(const StagingRing&) = delete;
+
+		void upload(uint32_t targetBufferID, size_t targetOffset, const void* data, size_t size);
+		void fence();
+
+		uint32_t getStallCount() const;
+
+		~StagingRing();
+
+	private:
+		struct Region
+		{
+			size_t start;
+			size_t end;
+			void* sync;
+		};
+
+		uint32_t bufferID;
+		size_t capacity;
+		size_t head;
+		size_t unfencedStart;
+		std::deque<Region> regions;
+		uint32_t stallCount;
+
+		void retireRegions(size_t start, size_t end);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -1,6 +1,13 @@
 #include "Terrain.h"
 #include <glm/gtc/constants.hpp>
 #include <inttypes.h>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YAMC_NOISE_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace yamc
 {
@@ -67,19 +74,148 @@ namespace yamc
 		return glm::clamp(value, -1.0f, 1.0f);
 	}
 
+	struct NoiseAxis
+	{
+		std::vector<int> lattice;
+		std::vector<float> fraction;
+		std::vector<float> weight;
+
+		void build(int minIndex, int count, float gridSize, float scale)
+		{
+			lattice.resize(count);
+			fraction.resize(count);
+			weight.resize(count);
+			for (int i = 0; i < count; i++) {
+				float position = (minIndex + i) / gridSize * scale;
+				lattice[i] = (int)floorf(position);
+				fraction[i] = position - lattice[i];
+				weight[i] = smoothStep(fraction[i]);
+			}
+		}
+	};
+
+	void octavePerlinGrid(int minX, int minZ, int width, int length, float gridSize, int seed, int octaves, float* values)
+	{
+		std::fill(values, values + width * length, 0.0f);
+
+		NoiseAxis axisX, axisZ;
+		std::vector<glm::vec2> gradients;
+		std::vector<float> rowGradients[8];
+		std::vector<float> row(width);
+		for (auto& gradientRow : rowGradients) {
+			gradientRow.resize(width);
+		}
+
+		for (int octave = 0; octave < octaves; octave++) {
+			float s = powf(2.0f, octave);
+			double amplitude = 1.0 / s;
+			axisX.build(minX, width, gridSize, s);
+			axisZ.build(minZ, length, gridSize, s);
+
+			int minLatticeX = axisX.lattice.front();
+			int minLatticeZ = axisZ.lattice.front();
+			int latticeWidth = axisX.lattice.back() - minLatticeX + 2;
+			int latticeLength = axisZ.lattice.back() - minLatticeZ + 2;
+			gradients.resize(latticeWidth * latticeLength);
+			for (int z = 0; z < latticeLength; z++) {
+				for (int x = 0; x < latticeWidth; x++) {
+					gradients[z * latticeWidth + x] = randomDirection(minLatticeX + x, minLatticeZ + z, seed);
+				}
+			}
+
+			int currentLatticeZ = minLatticeZ - 1;
+			for (int z = 0; z < length; z++) {
+				if (axisZ.lattice[z] != currentLatticeZ) {
+					currentLatticeZ = axisZ.lattice[z];
+					int topRow = (currentLatticeZ - minLatticeZ) * latticeWidth - minLatticeX;
+					int bottomRow = topRow + latticeWidth;
+					for (int x = 0; x < width; x++) {
+						int latticeX = axisX.lattice[x];
+						rowGradients[0][x] = gradients[topRow + latticeX].x;
+						rowGradients[1][x] = gradients[topRow + latticeX].y;
+						rowGradients[2][x] = gradients[topRow + latticeX + 1].x;
+						rowGradients[3][x] = gradients[topRow + latticeX + 1].y;
+						rowGradients[4][x] = gradients[bottomRow + latticeX].x;
+						rowGradients[5][x] = gradients[bottomRow + latticeX].y;
+						rowGradients[6][x] = gradients[bottomRow + latticeX + 1].x;
+						rowGradients[7][x] = gradients[bottomRow + latticeX + 1].y;
+					}
+				}
+
+				float fz = axisZ.fraction[z];
+				float wz = axisZ.weight[z];
+				int x = 0;
+
+#ifdef YAMC_NOISE_SSE2
+				__m128 one = _mm_set1_ps(1.0f);
+				__m128 fz4 = _mm_set1_ps(fz);
+				__m128 fz4m1 = _mm_set1_ps(fz - 1.0f);
+				__m128 wz4 = _mm_set1_ps(wz);
+				for (; x + 4 <= width; x += 4) {
+					__m128 fx = _mm_loadu_ps(&axisX.fraction[x]);
+					__m128 fxm1 = _mm_sub_ps(fx, one);
+					__m128 wx = _mm_loadu_ps(&axisX.weight[x]);
+
+					__m128 tl = _mm_add_ps(_mm_mul_ps(fx, _mm_loadu_ps(&rowGradients[0][x])), _mm_mul_ps(fz4, _mm_loadu_ps(&rowGradients[1][x])));
+					__m128 tr = _mm_add_ps(_mm_mul_ps(fxm1, _mm_loadu_ps(&rowGradients[2][x])), _mm_mul_ps(fz4, _mm_loadu_ps(&rowGradients[3][x])));
+					__m128 bl = _mm_add_ps(_mm_mul_ps(fx, _mm_loadu_ps(&rowGradients[4][x])), _mm_mul_ps(fz4m1, _mm_loadu_ps(&rowGradients[5][x])));
+					__m128 br = _mm_add_ps(_mm_mul_ps(fxm1, _mm_loadu_ps(&rowGradients[6][x])), _mm_mul_ps(fz4m1, _mm_loadu_ps(&rowGradients[7][x])));
+
+					__m128 wxInverse = _mm_sub_ps(one, wx);
+					__m128 top = _mm_add_ps(_mm_mul_ps(wxInverse, tl), _mm_mul_ps(wx, tr));
+					__m128 bottom = _mm_add_ps(_mm_mul_ps(wxInverse, bl), _mm_mul_ps(wx, br));
+					__m128 noise = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, wz4), top), _mm_mul_ps(wz4, bottom));
+					_mm_storeu_ps(&row[x], noise);
+				}
+#endif
+
+				for (; x < width; x++) {
+					float fx = axisX.fraction[x];
+					float wx = axisX.weight[x];
+					float tl = fx * rowGradients[0][x] + fz * rowGradients[1][x];
+					float tr = (fx - 1.0f) * rowGradients[2][x] + fz * rowGradients[3][x];
+					float bl = fx * rowGradients[4][x] + (fz - 1.0f) * rowGradients[5][x];
+					float br = (fx - 1.0f) * rowGradients[6][x] + (fz - 1.0f) * rowGradients[7][x];
+					float top = (1.0f - wx) * tl + wx * tr;
+					float bottom = (1.0f - wx) * bl + wx * br;
+					row[x] = (1.0f - wz) * top + wz * bottom;
+				}
+
+				float* rowValues = values + z * width;
+				for (x = 0; x < width; x++) {
+					rowValues[x] += amplitude * row[x];
+				}
+			}
+		}
+
+		for (int i = 0; i < width * length; i++) {
+			values[i] = glm::clamp(values[i], -1.0f, 1.0f);
+		}
+	}
+
+	constexpr int MinSurfaceHeight = 32;
+	constexpr int MaxSurfaceHeight = 64;
+	constexpr float SurfaceGridSize = 64.0f;
+	constexpr int SurfaceOctaves = 3;
+
+	int getSurfaceHeightFromNoise(float noise)
+	{
+		return MinSurfaceHeight + (MaxSurfaceHeight - MinSurfaceHeight) * (0.5f + noise * 0.5f);
+	}
+
+	int getSurfaceHeight(int worldX, int worldZ, int seed)
+	{
+		return getSurfaceHeightFromNoise(octavePerlin(worldX / SurfaceGridSize, worldZ / SurfaceGridSize, seed, SurfaceOctaves));
+	}
+
 	void fillChunk(Chunk* chunk, int offsetX, int offsetZ, int seed)
 	{
-		int maxHeight = 64;
-		int minHeight = 32;
-		float gridSize = 64.0f;
+		float noise[Chunk::MaxWidth * Chunk::MaxLength];
+		octavePerlinGrid(offsetX * Chunk::MaxWidth, offsetZ * Chunk::MaxLength, Chunk::MaxWidth, Chunk::MaxLength, SurfaceGridSize, seed, SurfaceOctaves, noise);
 
 		for (int x = 0; x < Chunk::MaxWidth; x++) {
 			for (int z = 0; z < Chunk::MaxLength; z++) {
-				int worldX = x + offsetX * Chunk::MaxWidth;
-				int worldZ = z + offsetZ * Chunk::MaxLength;
-
-				float noise = octavePerlin(worldX / gridSize, worldZ / gridSize, seed, 3);
-				int height = minHeight + (maxHeight - minHeight) * (0.5f + noise * 0.5f);
+				int height = getSurfaceHeightFromNoise(noise[z * Chunk::MaxWidth + x]);
 				for (int y = 0; y <= height; y++) {
 					chunk->setBlock(x, y, z, y == height ? 2 : 1);
 				}
@@ -126,10 +262,53 @@ namespace yamc
 		return localIndex >= 0 ? localIndex : chunkSize - localIndex - 1;
 	}
 			
+	constexpr uint32_t ChunkLookupCacheSize = 4;
+
+	struct ChunkLookupCache
+	{
+		const ChunkTable* table;
+		uint32_t version;
+		uint64_t keys[ChunkLookupCacheSize];
+		Chunk* chunks[ChunkLookupCacheSize];
+	};
+
+	thread_local ChunkLookupCache chunkLookupCache = {};
+
+	ChunkNeighborhood::ChunkNeighborhood() :
+		chunkKey(0),
+		sectionMask(0),
+		blocks(Width * Height * Length, 0)
+	{
+	}
+
 	Terrain::Terrain()
 	{
 	}
 
+	Chunk* Terrain::findChunk(int32_t chunkX, int32_t chunkZ) const
+	{
+		ChunkLookupCache& cache = chunkLookupCache;
+		if (cache.table != &chunks || cache.version != chunks.getVersion()) {
+			cache = {};
+			cache.table = &chunks;
+			cache.version = chunks.getVersion();
+		}
+
+		uint64_t key = getChunkKey(chunkX, chunkZ);
+		uint32_t cacheIndex = (chunkX & 1) | ((chunkZ & 1) << 1);
+		if (cache.chunks[cacheIndex] != nullptr && cache.keys[cacheIndex] == key) {
+			return cache.chunks[cacheIndex];
+		}
+
+		Chunk* chunk = chunks.get(key);
+		if (chunk != nullptr) {
+			cache.keys[cacheIndex] = key;
+			cache.chunks[cacheIndex] = chunk;
+		}
+
+		return chunk;
+	}
+
 	bool Terrain::findBlock(Chunk** outChunk, uint32_t& localX, uint32_t& localZ, uint64_t& chunkKey, int x, int y, int z) const
 	{
 		if (y < 0 || y >= Chunk::MaxHeight) {
@@ -139,16 +318,15 @@ namespace yamc
 		int32_t chunkX = getChunkIndex(x, Chunk::MaxWidth);
 		int32_t chunkZ = getChunkIndex(z, Chunk::MaxLength);
 
-		uint64_t key = getChunkKey(chunkX, chunkZ);
-		auto chunk = chunks.find(key);
-		if (chunk == chunks.end()) {
+		Chunk* chunk = findChunk(chunkX, chunkZ);
+		if (chunk == nullptr) {
 			return false;
 		}
 
-		chunkKey = key;
+		chunkKey = getChunkKey(chunkX, chunkZ);
 		localX = getLocalBlockIndex(x, Chunk::MaxWidth);
 		localZ = getLocalBlockIndex(z, Chunk::MaxLength);
-		*outChunk = chunk->second;
+		*outChunk = chunk;
 
 		return true;
 	}
@@ -165,6 +343,100 @@ namespace yamc
 		return chunk->getBlock(localX, y, localZ);
 	}
 
+	bool Terrain::isSectionEmpty(int x, int y, int z) const
+	{
+		Chunk* chunk = nullptr;
+		uint32_t localX, localZ;
+		uint64_t chunkKey;
+		if (!findBlock(&chunk, localX, localZ, chunkKey, x, y, z)) {
+			return true;
+		}
+
+		return chunk->getSection(y / Chunk::SectionHeight) == nullptr;
+	}
+
+	bool Terrain::copyNeighborhood(uint64_t chunkKey, ChunkNeighborhood& neighborhood) const
+	{
+		const Chunk* chunk = chunks.get(chunkKey);
+		if (chunk == nullptr) {
+			return false;
+		}
+
+		neighborhood.chunkKey = chunkKey;
+		neighborhood.sectionMask = 0;
+		std::fill(neighborhood.blocks.begin(), neighborhood.blocks.end(), 0);
+
+		uint32_t sectionBlocks[ChunkSection::BlockCount];
+		for (uint32_t i = 0; i < Chunk::SectionCount; i++) {
+			const ChunkSection* section = chunk->getSection(i);
+			if (section == nullptr) {
+				continue;
+			}
+
+			neighborhood.sectionMask |= 1 << i;
+			section->unpack(sectionBlocks);
+
+			const uint32_t* row = sectionBlocks;
+			for (uint32_t y = 0; y < Chunk::SectionHeight; y++) {
+				for (uint32_t z = 0; z < Chunk::MaxLength; z++) {
+					uint32_t* dst = &neighborhood.blocks[ChunkNeighborhood::getIndex(0, i * Chunk::SectionHeight + y, z)];
+					memcpy(dst, row, Chunk::MaxWidth * sizeof(uint32_t));
+					row += Chunk::MaxWidth;
+				}
+			}
+		}
+
+		auto chunkOffset = getChunkOffset(chunkKey);
+		for (int dz = -1; dz <= 1; dz++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				if (dx == 0 && dz == 0) {
+					continue;
+				}
+
+				const Chunk* neighbor = chunks.get(getChunkKey(chunkOffset[0] + dx, chunkOffset[1] + dz));
+				if (neighbor == nullptr) {
+					continue;
+				}
+
+				int minX = dx < 0 ? Chunk::MaxWidth - 1 : 0;
+				int maxX = dx > 0 ? 0 : Chunk::MaxWidth - 1;
+				int minZ = dz < 0 ? Chunk::MaxLength - 1 : 0;
+				int maxZ = dz > 0 ? 0 : Chunk::MaxLength - 1;
+
+				for (uint32_t i = 0; i < Chunk::SectionCount; i++) {
+					const ChunkSection* section = neighbor->getSection(i);
+					if (section == nullptr) {
+						continue;
+					}
+
+					for (uint32_t y = 0; y < Chunk::SectionHeight; y++) {
+						for (int z = minZ; z <= maxZ; z++) {
+							for (int x = minX; x <= maxX; x++) {
+								int index = ChunkNeighborhood::getIndex(x + dx * Chunk::MaxWidth, i * Chunk::SectionHeight + y, z + dz * Chunk::MaxLength);
+								neighborhood.blocks[index] = section->getBlock(x, y, z);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool Terrain::areNeighborsLoaded(uint64_t chunkKey) const
+	{
+		auto chunkOffset = getChunkOffset(chunkKey);
+		for (int dz = -1; dz <= 1; dz++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				if ((dx != 0 || dz != 0) && chunks.count(getChunkKey(chunkOffset[0] + dx, chunkOffset[1] + dz)) == 0) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
 	void Terrain::setBlock(int x, int y, int z, uint32_t id)
 	{
 		Chunk* chunk = nullptr;
@@ -178,28 +450,32 @@ namespace yamc
 
 		chunkKeysToSave.insert(chunkKey);
 		
-		auto chunkOffset = getChunkOffset(chunkKey);
-		chunkKeysToRebuild.insert(chunkKey);
-		if (localX == 0) {
-			addToRebuildIfExists(chunkOffset[0] - 1, chunkOffset[1]);
-		}
-		if (localX == Chunk::MaxWidth - 1) {
-			addToRebuildIfExists(chunkOffset[0] + 1, chunkOffset[1]);
-		}
-		if (localZ == 0) {
-			addToRebuildIfExists(chunkOffset[0], chunkOffset[1] - 1);
+		uint8_t sectionMask = 0;
+		for (int dy = -1; dy <= 1; dy++) {
+			if (y + dy >= 0 && y + dy < (int)Chunk::MaxHeight) {
+				sectionMask |= 1 << ((y + dy) / Chunk::SectionHeight);
+			}
 		}
-		if (localZ == Chunk::MaxLength - 1) {
-			addToRebuildIfExists(chunkOffset[0], chunkOffset[1] + 1);
+
+		int minDX = localX == 0 ? -1 : 0;
+		int maxDX = localX == Chunk::MaxWidth - 1 ? 1 : 0;
+		int minDZ = localZ == 0 ? -1 : 0;
+		int maxDZ = localZ == Chunk::MaxLength - 1 ? 1 : 0;
+
+		auto chunkOffset = getChunkOffset(chunkKey);
+		for (int dx = minDX; dx <= maxDX; dx++) {
+			for (int dz = minDZ; dz <= maxDZ; dz++) {
+				addSectionsToRebuildIfExists(chunkOffset[0] + dx, chunkOffset[1] + dz, sectionMask);
+			}
 		}
 	}
 
-	const std::unordered_map<uint64_t, Chunk*>& Terrain::getChunks() const
+	const ChunkTable& Terrain::getChunks() const
 	{
 		return chunks;
 	}
 
-	std::unordered_map<uint64_t, Chunk*>& Terrain::getChunks()
+	ChunkTable& Terrain::getChunks()
 	{
 		return chunks;
 	}
@@ -224,6 +500,21 @@ namespace yamc
 		return chunkKeysToRebuild;
 	}
 
+	const std::map<uint64_t, uint8_t>& Terrain::getSectionsToRebuild() const
+	{
+		return sectionsToRebuild;
+	}
+
+	std::map<uint64_t, uint8_t>& Terrain::getSectionsToRebuild()
+	{
+		return sectionsToRebuild;
+	}
+
+	ChunkPool& Terrain::getChunkPool()
+	{
+		return chunkPool;
+	}
+
 	void Terrain::addToRebuildWithAdjacent(uint64_t key)
 	{
 		chunkKeysToRebuild.insert(key);
@@ -240,15 +531,23 @@ namespace yamc
 	void Terrain::addToRebuildIfExists(int x, int z)
 	{
 		uint64_t key = getChunkKey(x, z);
-		if (chunks.find(key) != chunks.end()) {
+		if (chunks.count(key) > 0) {
 			chunkKeysToRebuild.insert(key);
 		}
 	}
 
+	void Terrain::addSectionsToRebuildIfExists(int x, int z, uint8_t sectionMask)
+	{
+		uint64_t key = getChunkKey(x, z);
+		if (chunks.count(key) > 0) {
+			sectionsToRebuild[key] |= sectionMask;
+		}
+	}
+
 	Terrain::~Terrain()
 	{
 		for (const auto& pair : chunks) {
-			delete pair.second;
+			chunkPool.releaseChunk(pair.second);
 		}
 	}
 }
\ No newline at end of file
@@ -1,10 +1,13 @@
 #ifndef YAMC_TERRAIN_H
 #define YAMC_TERRAIN_H
 
-#include <unordered_map>
 #include <set>
+#include <map>
+#include <vector>
 #include <stdint.h>
 #include "Chunk.h"
+#include "ChunkPool.h"
+#include "ChunkTable.h"
 
 namespace yamc
 {
@@ -12,28 +15,63 @@ namespace yamc
 	uint32_t getLocalBlockIndex(int worldIndex, uint32_t chunkSize);
 	uint64_t getChunkKey(int high, int low);
 	glm::ivec2 getChunkOffset(uint64_t key);
+	void octavePerlinGrid(int minX, int minZ, int width, int length, float gridSize, int seed, int octaves, float* values);
+	int getSurfaceHeight(int worldX, int worldZ, int seed);
 	void fillChunk(Chunk* chunk, int offsetX, int offsetZ, int seed);
 
+	struct ChunkNeighborhood
+	{
+		static constexpr int Width = Chunk::MaxWidth + 2;
+		static constexpr int Height = Chunk::MaxHeight + 2;
+		static constexpr int Length = Chunk::MaxLength + 2;
+
+		uint64_t chunkKey;
+		uint8_t sectionMask;
+		std::vector<uint32_t> blocks;
+
+		ChunkNeighborhood();
+
+		static int getIndex(int x, int y, int z)
+		{
+			return ((y + 1) * Length + (z + 1)) * Width + (x + 1);
+		}
+
+		uint32_t getBlock(int x, int y, int z) const
+		{
+			return blocks[getIndex(x, y, z)];
+		}
+	};
+
 	class Terrain
 	{
 	public:
 		Terrain();
 		uint32_t getBlock(int x, int y, int z) const;
+		bool isSectionEmpty(int x, int y, int z) const;
+		bool copyNeighborhood(uint64_t chunkKey, ChunkNeighborhood& neighborhood) const;
+		bool areNeighborsLoaded(uint64_t chunkKey) const;
 		void setBlock(int x, int y, int z, uint32_t id);
-		const std::unordered_map<uint64_t, Chunk*>& getChunks() const;
-		std::unordered_map<uint64_t, Chunk*>& getChunks();
+		const ChunkTable& getChunks() const;
+		ChunkTable& getChunks();
 		const std::set<uint64_t>& getChunkKeysToSave() const;
 		std::set<uint64_t>& getChunkKeysToSave();
 		const std::set<uint64_t>& getChunkKeysToRebuild() const;
 		std::set<uint64_t>& getChunkKeysToRebuild();
+		const std::map<uint64_t, uint8_t>& getSectionsToRebuild() const;
+		std::map<uint64_t, uint8_t>& getSectionsToRebuild();
+		ChunkPool& getChunkPool();
 		void addToRebuildWithAdjacent(uint64_t key);
 		void addToRebuildIfExists(int x, int z);
+		void addSectionsToRebuildIfExists(int x, int z, uint8_t sectionMask);
 		~Terrain();
 
 	private:
-		std::unordered_map<uint64_t, Chunk*> chunks;
+		ChunkPool chunkPool;
+		ChunkTable chunks;
 		std::set<uint64_t> chunkKeysToSave;
 		std::set<uint64_t> chunkKeysToRebuild;
+		std::map<uint64_t, uint8_t> sectionsToRebuild;
+		Chunk* findChunk(int32_t chunkX, int32_t chunkZ) const;
 		bool findBlock(Chunk** chunk, uint32_t& localX, uint32_t& localY, uint64_t& chunkKey, int x, int y, int z) const;
 	};
 }
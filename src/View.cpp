@@ -22,6 +22,10 @@ namespace yamc
 	{
 	}
 
+	void View::onKeyPress(int, int)
+	{
+	}
+
 	bool View::isKeyPressed(int key) const
 	{
 		return glfwGetKey(application->getWindow(), key) == GLFW_PRESS;
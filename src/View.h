@@ -17,6 +17,7 @@ namespace yamc
 		virtual void scroll(double delta);
 		virtual void onMouseClick(int button, int mods);
 		virtual void onMouseRelease(int button, int mods);
+		virtual void onKeyPress(int key, int mods);
 		virtual void destroy() = 0;
 		virtual ~View();
 
@@ -0,0 +1,203 @@
+#include "Visibility.h"
+#include <algorithm>
+
+namespace yamc
+{
+	const glm::ivec3 SectionFaceDirections[SectionFaceCount] =
+	{
+		{0, 1, 0},
+		{0, -1, 0},
+		{0, 0, 1},
+		{0, 0, -1},
+		{1, 0, 0},
+		{-1, 0, 0}
+	};
+
+	int getOppositeFace(int face)
+	{
+		return face ^ 1;
+	}
+
+	uint16_t getFacePairBit(int faceA, int faceB)
+	{
+		if (faceA > faceB) {
+			std::swap(faceA, faceB);
+		}
+
+		int pairIndex = faceA * (2 * SectionFaceCount - faceA - 1) / 2 + (faceB - faceA - 1);
+		return 1 << pairIndex;
+	}
+
+	bool areSectionFacesConnected(uint16_t connectivity, int faceA, int faceB)
+	{
+		if (faceA == faceB) {
+			return true;
+		}
+		return (connectivity & getFacePairBit(faceA, faceB)) != 0;
+	}
+
+	uint16_t computeSectionConnectivity(const ChunkNeighborhood& neighborhood, int sectionIndex)
+	{
+		constexpr int Size = ChunkSection::Size;
+		constexpr int StrideZ = Size;
+		constexpr int StrideY = Size * Size;
+		const int Strides[SectionFaceCount] = { StrideY, -StrideY, StrideZ, -StrideZ, 1, -1 };
+
+		if ((neighborhood.sectionMask & (1 << sectionIndex)) == 0) {
+			return AllSectionFacesConnected;
+		}
+
+		int minY = sectionIndex * Chunk::SectionHeight;
+		bool isVisited[ChunkSection::BlockCount];
+		uint16_t stack[ChunkSection::BlockCount];
+		uint16_t connectivity = 0;
+
+		for (int y = 0; y < Size; y++) {
+			for (int z = 0; z < Size; z++) {
+				const uint32_t* row = &neighborhood.blocks[ChunkNeighborhood::getIndex(0, minY + y, z)];
+				for (int x = 0; x < Size; x++) {
+					isVisited[(y * Size + z) * Size + x] = row[x] != 0;
+				}
+			}
+		}
+
+		for (uint32_t start = 0; start < ChunkSection::BlockCount; start++) {
+			if (isVisited[start]) {
+				continue;
+			}
+
+			uint8_t touchedFaces = 0;
+			int stackSize = 0;
+			stack[stackSize++] = start;
+			isVisited[start] = true;
+
+			while (stackSize > 0) {
+				int cell = stack[--stackSize];
+				int x = cell % Size;
+				int z = (cell / Size) % Size;
+				int y = cell / (Size * Size);
+				bool isOnBorder[SectionFaceCount] = { y == Size - 1, y == 0, z == Size - 1, z == 0, x == Size - 1, x == 0 };
+
+				for (int face = 0; face < SectionFaceCount; face++) {
+					if (isOnBorder[face]) {
+						touchedFaces |= 1 << face;
+						continue;
+					}
+
+					int nextCell = cell + Strides[face];
+					if (!isVisited[nextCell]) {
+						isVisited[nextCell] = true;
+						stack[stackSize++] = nextCell;
+					}
+				}
+			}
+
+			for (int faceA = 0; faceA < SectionFaceCount; faceA++) {
+				for (int faceB = faceA + 1; faceB < SectionFaceCount; faceB++) {
+					if ((touchedFaces & (1 << faceA)) && (touchedFaces & (1 << faceB))) {
+						connectivity |= getFacePairBit(faceA, faceB);
+					}
+				}
+			}
+
+			if (connectivity == AllSectionFacesConnected) {
+				break;
+			}
+		}
+
+		return connectivity;
+	}
+
+	SectionVisibilityGrid::SectionVisibilityGrid() :
+		minChunkX(0),
+		minChunkZ(0),
+		chunksPerSide(0)
+	{
+	}
+
+	SectionVisibilityGrid::SectionVisibilityGrid(int minChunkX, int minChunkZ, int chunksPerSide)
+	{
+		reset(minChunkX, minChunkZ, chunksPerSide);
+	}
+
+	void SectionVisibilityGrid::reset(int minChunkX, int minChunkZ, int chunksPerSide)
+	{
+		this->minChunkX = minChunkX;
+		this->minChunkZ = minChunkZ;
+		this->chunksPerSide = chunksPerSide;
+		connectivity.assign(chunksPerSide * chunksPerSide * Chunk::SectionCount, AllSectionFacesConnected);
+		isVisible.assign(chunksPerSide * chunksPerSide * Chunk::SectionCount, 0);
+	}
+
+	bool SectionVisibilityGrid::contains(const glm::ivec3& section) const
+	{
+		return section.x >= minChunkX && section.x < minChunkX + chunksPerSide &&
+			section.z >= minChunkZ && section.z < minChunkZ + chunksPerSide &&
+			section.y >= 0 && section.y < (int)Chunk::SectionCount;
+	}
+
+	int SectionVisibilityGrid::getSectionIndex(const glm::ivec3& section) const
+	{
+		return ((section.z - minChunkZ) * chunksPerSide + (section.x - minChunkX)) * Chunk::SectionCount + section.y;
+	}
+
+	void SectionVisibilityGrid::setConnectivity(int chunkX, int chunkZ, int sectionIndex, uint16_t value)
+	{
+		connectivity[getSectionIndex(glm::ivec3(chunkX, sectionIndex, chunkZ))] = value;
+	}
+
+	bool SectionVisibilityGrid::isSectionVisible(int chunkX, int chunkZ, int sectionIndex) const
+	{
+		glm::ivec3 section(chunkX, sectionIndex, chunkZ);
+		return contains(section) && isVisible[getSectionIndex(section)] != 0;
+	}
+
+	void SectionVisibilityGrid::findVisibleSections(const glm::ivec3& startSection, const Frustum& frustum)
+	{
+		std::fill(isVisible.begin(), isVisible.end(), 0);
+		queue.clear();
+
+		glm::ivec3 start = startSection;
+		start.y = glm::clamp(start.y, 0, (int)Chunk::SectionCount - 1);
+		if (!contains(start)) {
+			return;
+		}
+
+		isVisible[getSectionIndex(start)] = 1;
+		queue.push_back({ start, -1, 0 });
+
+		for (size_t i = 0; i < queue.size(); i++) {
+			Step step = queue[i];
+			uint16_t sectionConnectivity = connectivity[getSectionIndex(step.section)];
+
+			for (int face = 0; face < SectionFaceCount; face++) {
+				if (step.directions & (1 << getOppositeFace(face))) {
+					continue;
+				}
+
+				if (step.entryFace >= 0 && !areSectionFacesConnected(sectionConnectivity, step.entryFace, face)) {
+					continue;
+				}
+
+				glm::ivec3 next = step.section + SectionFaceDirections[face];
+				if (!contains(next)) {
+					continue;
+				}
+
+				int nextIndex = getSectionIndex(next);
+				if (isVisible[nextIndex]) {
+					continue;
+				}
+
+				glm::vec3 min(next.x * (float)Chunk::MaxWidth, next.y * (float)Chunk::SectionHeight, next.z * (float)Chunk::MaxLength);
+				glm::vec3 max = min + glm::vec3(Chunk::MaxWidth, Chunk::SectionHeight, Chunk::MaxLength);
+				if (!frustum.intersectsBox(min, max)) {
+					continue;
+				}
+
+				isVisible[nextIndex] = 1;
+				queue.push_back({ next, getOppositeFace(face), (uint8_t)(step.directions | (1 << face)) });
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef YAMC_VISIBILITY_H
+#define YAMC_VISIBILITY_H
+
+#include "Terrain.h"
+#include "Frustum.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <stdint.h>
+
+namespace yamc
+{
+	constexpr int SectionFaceCount = 6;
+	constexpr uint16_t AllSectionFacesConnected = 0x7FFF;
+
+	bool areSectionFacesConnected(uint16_t connectivity, int faceA, int faceB);
+	uint16_t computeSectionConnectivity(const ChunkNeighborhood& neighborhood, int sectionIndex);
+
+	class SectionVisibilityGrid
+	{
+	public:
+		SectionVisibilityGrid();
+		SectionVisibilityGrid(int minChunkX, int minChunkZ, int chunksPerSide);
+
+		void reset(int minChunkX, int minChunkZ, int chunksPerSide);
+		void setConnectivity(int chunkX, int chunkZ, int sectionIndex, uint16_t connectivity);
+		void findVisibleSections(const glm::ivec3& startSection, const Frustum& frustum);
+		bool isSectionVisible(int chunkX, int chunkZ, int sectionIndex) const;
+
+	private:
+		struct Step
+		{
+			glm::ivec3 section;
+			int entryFace;
+			uint8_t directions;
+		};
+
+		int minChunkX;
+		int minChunkZ;
+		int chunksPerSide;
+		std::vector<uint16_t> connectivity;
+		std::vector<uint8_t> isVisible;
+		std::vector<Step> queue;
+
+		bool contains(const glm::ivec3& section) const;
+		int getSectionIndex(const glm::ivec3& section) const;
+	};
+}
+
+#endif
\ No newline at end of file
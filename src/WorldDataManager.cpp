@@ -1,5 +1,6 @@
 #include "WorldDataManager.h"
 #include <filesystem>
+#include <vector>
 
 namespace yamc
 {
@@ -10,31 +11,51 @@ namespace yamc
 		ensureWorldDirectoryExists();
 	}
 
-	Chunk* WorldDataManager::loadChunk(uint64_t key)
+	void WorldDataManager::loadChunk(uint64_t key, Chunk* chunk)
 	{
-		auto chunk = new Chunk();
+		std::vector<uint8_t> data;
+		bool isRead = false;
+		{
+			std::lock_guard<std::mutex> guard(fileMutex);
+			FILE* file = fopen(getChunkPath(key).c_str(), "rb");
+			if (file) {
+				fseek(file, 0, SEEK_END);
+				long size = ftell(file);
+				fseek(file, 0, SEEK_SET);
 
-		FILE* file = fopen(getChunkPath(key).c_str(), "rb");
-		if (file) {
-			fread(chunk->getData(), sizeof(uint32_t), Chunk::MaxHeight * Chunk::MaxLength * Chunk::MaxWidth, file);
-			fclose(file);
+				if (size > 0) {
+					data.resize(size);
+					isRead = fread(data.data(), 1, data.size(), file) == data.size();
+				}
+				fclose(file);
+			}
 		}
-		else {
+
+		bool isLoaded = isRead && chunk->deserialize(data.data(), data.size());
+
+		if (!isLoaded) {
 			auto offset = getChunkOffset(key);
 			fillChunk(chunk, offset[0], offset[1], seed);
 		}
-
-		return chunk;
 	}
 
 	void WorldDataManager::saveChunk(uint64_t key, const Chunk* chunk) const
 	{
+		std::vector<uint8_t> data;
+		chunk->serialize(data);
+
 		auto path = getChunkPath(key);
+		std::lock_guard<std::mutex> guard(fileMutex);
 		FILE* file = fopen(path.c_str(), "wb");
-		fwrite(chunk->getData(), sizeof(uint32_t), Chunk::MaxHeight * Chunk::MaxLength * Chunk::MaxWidth, file);
+		fwrite(data.data(), 1, data.size(), file);
 		fclose(file);
 	}
 
+	int WorldDataManager::getSeed() const
+	{
+		return seed;
+	}
+
 	std::string WorldDataManager::getChunkPath(uint64_t key) const
 	{
 		return directoryPath + std::to_string(key) + ".cnk";
@@ -2,6 +2,7 @@
 #define YAMC_WORLD_DATA_MANAGER_H
 
 #include <string>
+#include <mutex>
 #include "Terrain.h"
 
 namespace yamc
@@ -10,12 +11,14 @@ namespace yamc
 	{
 	public:
 		WorldDataManager(int seed, const std::string& worldName);
-		Chunk* loadChunk(uint64_t key);
+		void loadChunk(uint64_t key, Chunk* chunk);
 		void saveChunk(uint64_t key, const Chunk* chunk) const;
+		int getSeed() const;
 
 	private:
 		int seed;
 		std::string directoryPath;
+		mutable std::mutex fileMutex;
 
 		std::string getChunkPath(uint64_t key) const;
 		void ensureWorldDirectoryExists() const;
@@ -0,0 +1,130 @@
+#include "../Terrain.h"
+#include <unordered_map>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <cstdio>
+
+using namespace yamc;
+
+static constexpr int GridRadius = 10;
+static constexpr int Seed = 542917;
+static constexpr int RunCount = 3;
+static constexpr size_t ScatteredLookupCount = 4 * 1024 * 1024;
+
+static const int NeighborOffsets[7][3] = {
+	{ 0, 0, 0 }, { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 }
+};
+
+// Lookup path used before ChunkTable: a plain std::unordered_map find per block.
+class UnorderedMapTerrain
+{
+public:
+	UnorderedMapTerrain(const ChunkTable& chunks)
+	{
+		for (auto& pair : chunks) {
+			this->chunks[pair.first] = pair.second;
+		}
+	}
+
+	uint32_t getBlock(int x, int y, int z) const
+	{
+		if (y < 0 || y >= Chunk::MaxHeight) {
+			return 0;
+		}
+
+		auto chunk = chunks.find(getChunkKey(getChunkIndex(x, Chunk::MaxWidth), getChunkIndex(z, Chunk::MaxLength)));
+		if (chunk == chunks.end()) {
+			return 0;
+		}
+
+		return chunk->second->getBlock(getLocalBlockIndex(x, Chunk::MaxWidth), y, getLocalBlockIndex(z, Chunk::MaxLength));
+	}
+
+private:
+	std::unordered_map<uint64_t, Chunk*> chunks;
+};
+
+template<typename TerrainType>
+static double measureCoherent(const TerrainType& terrain, uint64_t& checksum)
+{
+	double bestNanoseconds = (std::numeric_limits<double>::max)();
+	for (int run = 0; run < RunCount; run++) {
+		size_t lookupCount = 0;
+		auto startTime = std::chrono::steady_clock::now();
+		for (int chunkX = -GridRadius + 1; chunkX < GridRadius; chunkX++) {
+			for (int chunkZ = -GridRadius + 1; chunkZ < GridRadius; chunkZ++) {
+				for (int y = 0; y < Chunk::MaxHeight; y++) {
+					for (int z = chunkZ * Chunk::MaxLength; z < (chunkZ + 1) * Chunk::MaxLength; z++) {
+						for (int x = chunkX * Chunk::MaxWidth; x < (chunkX + 1) * Chunk::MaxWidth; x++) {
+							for (auto& offset : NeighborOffsets) {
+								checksum += terrain.getBlock(x + offset[0], y + offset[1], z + offset[2]);
+							}
+							lookupCount += 7;
+						}
+					}
+				}
+			}
+		}
+		double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+		bestNanoseconds = (std::min)(bestNanoseconds, elapsed / lookupCount);
+	}
+	return bestNanoseconds;
+}
+
+template<typename TerrainType>
+static double measureScattered(const TerrainType& terrain, const std::vector<glm::ivec3>& positions, uint64_t& checksum)
+{
+	double bestNanoseconds = (std::numeric_limits<double>::max)();
+	for (int run = 0; run < RunCount; run++) {
+		auto startTime = std::chrono::steady_clock::now();
+		for (auto& position : positions) {
+			checksum += terrain.getBlock(position.x, position.y, position.z);
+		}
+		double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+		bestNanoseconds = (std::min)(bestNanoseconds, elapsed / positions.size());
+	}
+	return bestNanoseconds;
+}
+
+int main()
+{
+	Terrain terrain;
+	ChunkTable& chunks = terrain.getChunks();
+	for (int x = -GridRadius; x <= GridRadius; x++) {
+		for (int z = -GridRadius; z <= GridRadius; z++) {
+			Chunk* chunk = terrain.getChunkPool().acquireChunk();
+			fillChunk(chunk, x, z, Seed);
+			chunks[getChunkKey(x, z)] = chunk;
+		}
+	}
+	UnorderedMapTerrain unorderedMapTerrain(chunks);
+
+	std::mt19937 random(Seed);
+	std::uniform_int_distribution<int> horizontal(-GridRadius * Chunk::MaxWidth, (GridRadius + 1) * Chunk::MaxWidth - 1);
+	std::uniform_int_distribution<int> vertical(0, Chunk::MaxHeight - 1);
+	std::vector<glm::ivec3> positions(ScatteredLookupCount);
+	for (auto& position : positions) {
+		position = glm::ivec3(horizontal(random), vertical(random), horizontal(random));
+	}
+
+	uint64_t checksum = 0;
+	uint64_t referenceChecksum = 0;
+	double coherentBefore = measureCoherent(unorderedMapTerrain, referenceChecksum);
+	double coherentAfter = measureCoherent(terrain, checksum);
+	double scatteredBefore = measureScattered(unorderedMapTerrain, positions, referenceChecksum);
+	double scatteredAfter = measureScattered(terrain, positions, checksum);
+
+	printf("Terrain::getBlock on %dx%d generated chunks, best of %d runs (ns per lookup)\n", GridRadius * 2 + 1, GridRadius * 2 + 1, RunCount);
+	printf("  meshing-like (block plus 6 neighbours): unordered_map %.1f, ChunkTable %.1f\n", coherentBefore, coherentAfter);
+	printf("  scattered random chunks:                unordered_map %.1f, ChunkTable %.1f\n", scatteredBefore, scatteredAfter);
+
+	if (checksum != referenceChecksum) {
+		printf("Checksum mismatch: %llu != %llu\n", (unsigned long long)checksum, (unsigned long long)referenceChecksum);
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
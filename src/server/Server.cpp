@@ -144,8 +144,11 @@ namespace yamc
 
 		auto chunk = chunkEntry->second;
 
+		std::vector<uint8_t> chunkData;
+		chunk->serialize(chunkData);
+
 		std::vector<uint8_t> compressedData;
-		compressData(chunk->getData(), Chunk::MaxHeight * Chunk::MaxLength * Chunk::MaxWidth * sizeof(uint32_t), compressedData);
+		compressData(chunkData.data(), chunkData.size(), compressedData);
 
 		size_t offset = 0;
 		size_t totalSize = compressedData.size();
@@ -153,6 +156,7 @@ namespace yamc
 		packageBuffer.rewind();
 		packageBuffer.writeByte((uint8_t)ResponseCodes::ChunkDataStart);
 		packageBuffer.writeUint32(totalSize);
+		packageBuffer.writeUint32(chunkData.size());
 		size_t bytesToWrite = std::min(packageBuffer.getAvailableSpace(), totalSize);
 		packageBuffer.writeBuffer(compressedData.data(), bytesToWrite);
 		if (!sendPackage(packageBuffer, client)) {
@@ -199,7 +203,7 @@ namespace yamc
 			Chunk* chunk = nullptr;
 			auto chunkEntry = chunks.find(chunkKey);
 			if (chunkEntry == chunks.end()) {
-				chunk = new Chunk;
+				chunk = chunkPool.acquireChunk();
 				fillChunk(chunk, chunkX, chunkZ, seed);
 				chunks[chunkKey] = chunk;
 			}
@@ -264,8 +268,9 @@ namespace yamc
 		isRunning = false;
 		serverThread.join();
 		for (auto chunkEntry : chunks) {
-			delete chunkEntry.second;
+			chunkPool.releaseChunk(chunkEntry.second);
 		}
+		chunks.clear();
 	}
 
 	Server::~Server()
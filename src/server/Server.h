@@ -40,6 +40,7 @@ namespace yamc
 		std::thread serverThread;
 		std::atomic_bool isRunning;
 		std::set<ClientInfo*> clients;
+		ChunkPool chunkPool;
 		std::unordered_map<uint64_t, Chunk*> chunks;
 		std::mutex terrainMutex;
 
@@ -0,0 +1,94 @@
+#include "../Visibility.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cstdio>
+
+using namespace yamc;
+
+static int failureCount = 0;
+
+static void check(bool condition, const char* description)
+{
+	if (!condition) {
+		printf("FAILED: %s\n", description);
+		failureCount++;
+	}
+}
+
+static void fillSection(ChunkNeighborhood& neighborhood, int sectionIndex, bool isHollow)
+{
+	int minY = sectionIndex * Chunk::SectionHeight;
+	for (int y = 0; y < (int)Chunk::SectionHeight; y++) {
+		for (int z = 0; z < (int)Chunk::MaxLength; z++) {
+			for (int x = 0; x < (int)Chunk::MaxWidth; x++) {
+				bool isShell = y == 0 || y == Chunk::SectionHeight - 1 || z == 0 || z == Chunk::MaxLength - 1 || x == 0 || x == Chunk::MaxWidth - 1;
+				neighborhood.blocks[ChunkNeighborhood::getIndex(x, minY + y, z)] = isHollow && !isShell ? 0 : 1;
+			}
+		}
+	}
+	neighborhood.sectionMask |= 1 << sectionIndex;
+}
+
+static void testSealedSectionsAreNotConnected()
+{
+	ChunkNeighborhood neighborhood;
+	fillSection(neighborhood, 0, false);
+	fillSection(neighborhood, 1, true);
+
+	check(computeSectionConnectivity(neighborhood, 0) == 0, "solid section has no connected faces");
+	check(computeSectionConnectivity(neighborhood, 1) == 0, "hollow sealed section has no connected faces");
+}
+
+static void testEmptySectionsAreFullyConnected()
+{
+	ChunkNeighborhood neighborhood;
+	neighborhood.sectionMask = 1;
+
+	check(computeSectionConnectivity(neighborhood, 0) == AllSectionFacesConnected, "air-only section connects all faces");
+	check(computeSectionConnectivity(neighborhood, 1) == AllSectionFacesConnected, "missing section connects all faces");
+}
+
+static void testWallBlocksVisibility()
+{
+	constexpr int ChunksPerSide = 3;
+	constexpr int WallChunkX = 1;
+
+	SectionVisibilityGrid grid(0, 0, ChunksPerSide);
+	for (int z = 0; z < ChunksPerSide; z++) {
+		for (int sectionIndex = 0; sectionIndex < (int)Chunk::SectionCount; sectionIndex++) {
+			grid.setConnectivity(WallChunkX, z, sectionIndex, 0);
+		}
+	}
+
+	Frustum frustum(glm::ortho(-1000.0f, 1000.0f, -1000.0f, 1000.0f, -1000.0f, 1000.0f));
+	grid.findVisibleSections(glm::ivec3(0, 4, 1), frustum);
+
+	bool isStartSideVisible = true;
+	bool isWallVisible = false;
+	bool isFarSideVisible = false;
+	for (int z = 0; z < ChunksPerSide; z++) {
+		for (int sectionIndex = 0; sectionIndex < (int)Chunk::SectionCount; sectionIndex++) {
+			isStartSideVisible = isStartSideVisible && grid.isSectionVisible(0, z, sectionIndex);
+			isWallVisible = isWallVisible || grid.isSectionVisible(WallChunkX, z, sectionIndex);
+			isFarSideVisible = isFarSideVisible || grid.isSectionVisible(2, z, sectionIndex);
+		}
+	}
+
+	check(isStartSideVisible, "open sections on the camera side are visible");
+	check(isWallVisible, "wall sections facing the camera are visible");
+	check(!isFarSideVisible, "sections behind a solid wall are not visible");
+}
+
+int main()
+{
+	testSealedSectionsAreNotConnected();
+	testEmptySectionsAreFullyConnected();
+	testWallBlocksVisibility();
+
+	if (failureCount > 0) {
+		printf("%d check(s) failed.\n", failureCount);
+		return 1;
+	}
+
+	printf("All visibility checks passed.\n");
+	return 0;
+}
\ No newline at end of file